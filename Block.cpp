@@ -0,0 +1,95 @@
+#include "Block.hpp"
+#include "TxView.hpp"
+
+#include <optional>
+#include <algorithm>
+
+// One input and one output, both empty-scripted: the smallest valid transaction.
+static const size_t MIN_TX_SIZE = 60;
+
+Block::Block(std::span<const uint8_t> serialized_block, std::pmr::memory_resource* resource):
+    txs(resource) {
+    Reader reader(serialized_block);
+    Unserialize(reader);
+    if (!reader.Empty())
+        throw std::runtime_error("Block: trailing data");
+}
+
+Block::Block(std::span<const uint8_t> serialized_block, ThreadPool& pool,
+             std::pmr::memory_resource* resource):
+    txs(resource) {
+    Reader reader(serialized_block);
+    ::Unserialize(reader, header);
+
+    // `n_txs` is untrusted, reserve no more than the rest could hold.
+    uint64_t n_txs    = reader.ReadCompactSize();
+    uint64_t capacity = std::min<uint64_t>(n_txs, reader.Remaining() / MIN_TX_SIZE);
+    txs.reserve(capacity);
+    // Not worth waking the workers, all done in one pass here.
+    if (pool.Size() == 1 || n_txs < 64) {
+        for (uint64_t i = 0; i < n_txs; i++) {
+            auto& tx = txs.emplace_back(reader, resource);
+            tx.GetTxId();
+            tx.GetWTxId();
+        }
+    } else {
+        std::vector<std::span<const uint8_t>> serialized_txs;
+        serialized_txs.reserve(capacity);
+        for (uint64_t i = 0; i < n_txs; i++)
+            serialized_txs.push_back(TxView::Skip(reader));
+
+        // Tx can't be default-constructed in place, each worker fills its
+        // slots and they're moved (pointers only) into `txs` afterwards.
+        std::vector<std::optional<Tx>> parsed(n_txs);
+        pool.ParallelFor(n_txs, [&](size_t i, size_t) {
+            auto& tx = parsed[i].emplace(serialized_txs[i], resource);
+            tx.GetTxId();
+            tx.GetWTxId();
+        }, 16);
+        for (auto& tx: parsed)
+            txs.push_back(std::move(*tx));
+    }
+    if (!reader.Empty())
+        throw std::runtime_error("Block: trailing data");
+}
+
+std::vector<uint8_t> Block::Serialize() const {
+    std::vector<uint8_t> serialized(GetSerializedSize());
+    Serialize(serialized);
+    return serialized;
+}
+
+size_t Block::Serialize(std::span<uint8_t> out) const {
+    Writer writer(out);
+    Serialize(writer);
+    return writer.Position();
+}
+
+Block& Block::SetHeader(BlockHeader header) {
+    this->header = std::move(header);
+    return *this;
+}
+
+Block& Block::AddTx(Tx tx) {
+    txs.push_back(std::move(tx));
+    return *this;
+}
+
+Block& Block::SetTx(size_t i, Tx tx) {
+    txs.at(i) = std::move(tx);
+    return *this;
+}
+
+size_t Block::GetSerializedSize() const {
+    size_t size = FIXED_SIZE<BlockHeader> + GetCompactSizeSize(txs.size());
+    for (auto& tx: txs)
+        size += tx.GetSerializedSize();
+    return size;
+}
+
+size_t Block::GetStrippedSize() const {
+    size_t size = FIXED_SIZE<BlockHeader> + GetCompactSizeSize(txs.size());
+    for (auto& tx: txs)
+        size += tx.GetStrippedSize();
+    return size;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "BlockHeader.hpp"
+#include "Tx.hpp"
+#include "ThreadPool.hpp"
+
+#include <span>
+#include <vector>
+#include <memory_resource>
+
+// A header and its transactions, the first one being the coinbase.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/primitives/block.h#L62
+class Block {
+public:
+    Block() = delete;
+
+    Block(BlockHeader header, std::pmr::vector<Tx> txs):
+        header(std::move(header)), txs(std::move(txs)) {}
+
+    // Parse a whole serialized block, or consume one from `s`. As for Tx,
+    // the transactions (and everything in them) are allocated from
+    // `resource`, e.g. an arena released once the block has been processed.
+    explicit Block(std::span<const uint8_t>   serialized_block,
+                   std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    template <InStream Stream>
+    explicit Block(Stream& s, std::pmr::memory_resource* resource = std::pmr::get_default_resource()):
+        txs(resource) { Unserialize(s); }
+
+    // Same in two phases, for large blocks (initial sync, reindex): a pass
+    // over the lengths finds where every transaction starts, then `pool`
+    // parses them and computes their txid and wtxid in parallel. The workers
+    // share `resource`, which must be thread-safe: the default one or a
+    // std::pmr::synchronized_pool_resource, not a monotonic_buffer_resource.
+    // Small blocks, or a pool of 1, are parsed in one pass on the caller.
+    Block(std::span<const uint8_t>   serialized_block,
+          ThreadPool&                pool,
+          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Serialization with witnesses, allocated once / into `out` (at least
+    // GetSerializedSize() bytes, returns how many were written) / to any
+    // stream, or without them for the legacy format.
+    std::vector<uint8_t> Serialize() const;
+    size_t               Serialize(std::span<uint8_t> out) const;
+
+    const BlockHeader&          GetHeader() const { return header; }
+    const std::pmr::vector<Tx>& GetTxs()    const { return txs; }
+    const Hash256&              GetHash()   const { return header.GetHash(); }
+
+    // Builder, chainable. The merkle root isn't updated by AddTx, see
+    // BlockMerkleRoot() in merkle.hpp.
+    Block& SetHeader(BlockHeader header);
+    Block& AddTx(Tx tx);
+    Block& SetTx(size_t i, Tx tx);
+
+    // BIP141 sizes, from the transactions' (cached) ones.
+    size_t GetSerializedSize() const;
+    size_t GetStrippedSize()   const;
+    size_t GetWeight()         const { return GetStrippedSize() * 3 + GetSerializedSize(); }
+
+    template <OutStream Stream>
+    void Serialize(Stream& s, bool with_witness = true) const {
+        ::Serialize(s, header);
+        WriteCompactSize(s, txs.size());
+        for (auto& tx: txs)
+            tx.Serialize(s, with_witness);
+    }
+    template <InStream Stream>
+    void Unserialize(Stream& s) {
+        ::UnserializeMany(s, header, txs);
+    }
+
+private:
+    BlockHeader          header;
+    std::pmr::vector<Tx> txs;
+};
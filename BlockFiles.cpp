@@ -0,0 +1,271 @@
+#include "BlockFiles.hpp"
+#include "BlockHeader.hpp"
+#include "HashWriter.hpp"
+#include "Reader.hpp"
+#include "Writer.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+
+// Tags the index file, bumped whenever its layout changes.
+static const uint32_t INDEX_VERSION = 0x31584449; // "IDX1"
+
+BlockFiles::BlockFiles(const std::string& blocks_dir, const std::string& index_path, uint32_t magic):
+    magic(magic) {
+    Map(blocks_dir);
+
+    bool loaded = !index_path.empty() && LoadIndex(index_path);
+    if (!loaded) {
+        entries.clear();
+        scanned.clear();
+        by_hash.clear();
+    }
+    scanned.resize(files.size(), 0);
+
+    // Only the 88 bytes of framing and header of each block are read, let
+    // page faults bring in just those rather than reading ahead through the
+    // transactions.
+    size_t indexed = entries.size();
+    Advise(Access::Random);
+    for (uint32_t file = 0; file < files.size(); file++)
+        Scan(file);
+    Advise(Access::Normal);
+
+    BuildChain();
+    if (!index_path.empty() && (!loaded || entries.size() != indexed))
+        SaveIndex(index_path);
+}
+
+BlockFiles::~BlockFiles() {
+    for (auto& file: files)
+        if (file.size)
+            munmap((void*)file.data, file.size);
+}
+
+void BlockFiles::Map(const std::string& blocks_dir) {
+    // Core >= 28 XORs the block files with this key, all zeros if disabled.
+    std::ifstream xor_file(blocks_dir + "/xor.dat", std::ios::binary);
+    std::string key((std::istreambuf_iterator<char>(xor_file)), {});
+    if (std::any_of(key.begin(), key.end(), [](char c) { return c != 0; }))
+        throw std::runtime_error("BlockFiles: obfuscated block files (xor.dat) aren't supported");
+
+    for (unsigned n = 0;; n++) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "/blk%05u.dat", n);
+        std::string path = blocks_dir + name;
+
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno == ENOENT)
+                break;
+            throw std::system_error(errno, std::generic_category(), "BlockFiles: " + path);
+        }
+        struct stat st;
+        if (fstat(fd, &st) < 0) {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "BlockFiles: " + path);
+        }
+
+        File file;
+        file.size = st.st_size;
+        if (file.size) {
+            void* data = mmap(nullptr, file.size, PROT_READ, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED) {
+                int error = errno;
+                close(fd);
+                throw std::system_error(error, std::generic_category(), "BlockFiles: " + path);
+            }
+            file.data = (const uint8_t*)data;
+        }
+        close(fd); // the mapping keeps the file
+        files.push_back(file);
+    }
+}
+
+/* Index file:
+       uint32           INDEX_VERSION
+       uint32           magic
+       vector<uint32>   scanned, bytes of each block file covered
+       vector<Entry>    entries
+   An index for another network or for files since truncated is dropped
+   and everything scanned again. Files rewritten to the same size or more
+   (a -reindex) aren't detected, the index must then be deleted. */
+bool BlockFiles::LoadIndex(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)), {});
+
+    try {
+        Reader reader(content);
+        if (reader.Read<uint32_t>() != INDEX_VERSION || reader.Read<uint32_t>() != magic)
+            return false;
+        ::UnserializeMany(reader, scanned, entries);
+        if (!reader.Empty() || scanned.size() > files.size())
+            return false;
+    } catch (const std::runtime_error&) {
+        return false; // truncated
+    }
+
+    for (uint32_t i = 0; i < scanned.size(); i++)
+        if (scanned[i] > files[i].size)
+            return false;
+    for (auto& entry: entries)
+        if (entry.file >= scanned.size() || entry.offset < 8 ||
+            (uint64_t)entry.offset + entry.size > scanned[entry.file])
+            return false;
+
+    for (uint32_t i = 0; i < entries.size(); i++)
+        by_hash.try_emplace(entries[i].hash, i);
+    return true;
+}
+
+void BlockFiles::SaveIndex(const std::string& path) const {
+    std::vector<uint8_t> content;
+    VectorWriter writer(content);
+    ::SerializeMany(writer, INDEX_VERSION, magic, scanned, entries);
+
+    // Through a temporary file, so a crash leaves the previous index whole.
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        file.write((const char*)content.data(), content.size());
+        if (!file.flush())
+            throw std::runtime_error("BlockFiles: can't write " + tmp);
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+        throw std::system_error(errno, std::generic_category(), "BlockFiles: " + path);
+}
+
+// Same resynchronization as Core's LoadExternalBlockFile(): anything that
+// isn't a frame is skipped up to the next magic. The scan stops at
+// preallocated zeros or a block still being written, and picks up from
+// there next time.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/validation.cpp#L4636
+void BlockFiles::Scan(uint32_t file) {
+    const uint8_t* data = files[file].data;
+    size_t         size = files[file].size;
+    size_t         pos  = scanned[file];
+    uint8_t        start[4];
+    WriteLE32(start, magic);
+
+    while (pos + 8 + FIXED_SIZE<BlockHeader> <= size) {
+        uint32_t frame = ReadLE32(data + pos);
+        if (frame != magic) {
+            if (frame == 0)
+                break;
+            pos = std::search(data + pos + 1, data + size, start, start + 4) - data;
+            continue;
+        }
+        uint32_t length = ReadLE32(data + pos + 4);
+        if (length < FIXED_SIZE<BlockHeader> || pos + 8 + length > size)
+            break;
+
+        Entry entry;
+        entry.file   = file;
+        entry.offset = pos + 8;
+        entry.size   = length;
+        HashWriter hasher;
+        hasher.WriteBytes({data + entry.offset, FIXED_SIZE<BlockHeader>});
+        entry.hash = hasher.GetHash();
+        std::copy(data + entry.offset + 4, data + entry.offset + 36, entry.prev_block.begin());
+        AddEntry(entry);
+
+        pos = entry.offset + length;
+    }
+    scanned[file] = pos;
+}
+
+void BlockFiles::AddEntry(const Entry& entry) {
+    // A block stored twice (e.g. redownloaded) keeps its first copy.
+    if (by_hash.try_emplace(entry.hash, entries.size()).second)
+        entries.push_back(entry);
+}
+
+// Heights by following parents until a block of known height or the genesis
+// block (null parent), memoized so every entry is visited once. Blocks
+// whose ancestry isn't all there (still downloading) get none.
+void BlockFiles::BuildChain() {
+    const int32_t UNKNOWN = -2, ORPHAN = -1;
+    std::vector<int32_t>  height(entries.size(), UNKNOWN);
+    std::vector<uint32_t> path;
+    uint32_t best = 0;
+
+    for (uint32_t i = 0; i < entries.size(); i++) {
+        bool    rooted = false;
+        int32_t base   = -1; // height of the parent of path.back()
+        path.clear();
+        for (uint32_t j = i;;) {
+            if (height[j] != UNKNOWN) {
+                rooted = height[j] != ORPHAN;
+                base   = height[j];
+                break;
+            }
+            path.push_back(j);
+            if (entries[j].prev_block == Hash256{}) { // genesis
+                rooted = true;
+                break;
+            }
+            auto parent = by_hash.find(entries[j].prev_block);
+            if (parent == by_hash.end())
+                break;
+            j = parent->second;
+        }
+        for (size_t k = path.size(); k-- > 0;)
+            height[path[k]] = rooted ? ++base : ORPHAN;
+        // First seen wins a tie, like Core.
+        if (height[i] > height[best])
+            best = i;
+    }
+
+    chain.clear();
+    heights.assign(entries.size(), -1);
+    if (entries.empty() || height[best] < 0)
+        return;
+    chain.resize(height[best] + 1);
+    for (uint32_t j = best;; j = by_hash.at(entries[j].prev_block)) {
+        chain[height[j]] = j;
+        heights[j]       = height[j];
+        if (height[j] == 0)
+            break;
+    }
+}
+
+void BlockFiles::Advise(Access access) const {
+    int advice = access == Access::Sequential ? MADV_SEQUENTIAL :
+                 access == Access::Random     ? MADV_RANDOM     : MADV_NORMAL;
+    for (auto& file: files)
+        if (file.size)
+            madvise((void*)file.data, file.size, advice);
+}
+
+std::span<const uint8_t> BlockFiles::GetBlock(size_t height) const {
+    if (height >= chain.size())
+        throw std::runtime_error("BlockFiles: no block at height " + std::to_string(height));
+    return Bytes(entries[chain[height]]);
+}
+
+std::optional<std::span<const uint8_t>> BlockFiles::FindBlock(const Hash256& hash) const {
+    auto entry = by_hash.find(hash);
+    if (entry == by_hash.end())
+        return std::nullopt;
+    return Bytes(entries[entry->second]);
+}
+
+std::optional<size_t> BlockFiles::FindHeight(const Hash256& hash) const {
+    auto entry = by_hash.find(hash);
+    if (entry == by_hash.end() || heights[entry->second] < 0)
+        return std::nullopt;
+    return heights[entry->second];
+}
@@ -0,0 +1,62 @@
+#include "BlockHeader.hpp"
+#include "Reader.hpp"
+#include "Writer.hpp"
+#include "HashWriter.hpp"
+
+#include <stdexcept>
+
+BlockHeader::BlockHeader(std::span<const uint8_t> serialized_header) {
+    if (serialized_header.size() != FIXED_SIZE<BlockHeader>)
+        throw std::runtime_error("BlockHeader: expected 80 bytes");
+    Reader reader(serialized_header);
+    Unserialize(reader);
+}
+
+std::vector<uint8_t> BlockHeader::Serialize() const {
+    std::vector<uint8_t> serialized(FIXED_SIZE<BlockHeader>);
+    Writer writer(serialized);
+    Serialize(writer);
+    return serialized;
+}
+
+BlockHeader& BlockHeader::SetVersion(int32_t version) {
+    this->version = version;
+    hash.reset();
+    return *this;
+}
+
+BlockHeader& BlockHeader::SetPrevBlock(const Hash256& prev_block) {
+    this->prev_block = prev_block;
+    hash.reset();
+    return *this;
+}
+
+BlockHeader& BlockHeader::SetMerkleRoot(const Hash256& merkle_root) {
+    this->merkle_root = merkle_root;
+    hash.reset();
+    return *this;
+}
+
+BlockHeader& BlockHeader::SetTime(uint32_t time) {
+    this->time = time;
+    hash.reset();
+    return *this;
+}
+
+BlockHeader& BlockHeader::SetBits(uint32_t bits) {
+    this->bits = bits;
+    hash.reset();
+    return *this;
+}
+
+BlockHeader& BlockHeader::SetNonce(uint32_t nonce) {
+    this->nonce = nonce;
+    hash.reset();
+    return *this;
+}
+
+const Hash256& BlockHeader::GetHash() const {
+    if (!hash)
+        hash = SerializeHash(*this);
+    return *hash;
+}
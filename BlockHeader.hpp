@@ -0,0 +1,79 @@
+#pragma once
+
+#include "serialize.hpp"
+#include "hashes.hpp"
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <optional>
+
+// The 80-byte block header. Its hash (the block hash, serialized order) is
+// computed on first request and kept until the next change, same rules as
+// Tx's ids: go through the setters, query once before sharing.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/primitives/block.h#L20
+class BlockHeader {
+public:
+    BlockHeader() = default;
+
+    BlockHeader(int32_t        version,
+                const Hash256& prev_block,
+                const Hash256& merkle_root,
+                uint32_t       time,
+                uint32_t       bits,
+                uint32_t       nonce):
+                version(version),
+                prev_block(prev_block),
+                merkle_root(merkle_root),
+                time(time),
+                bits(bits),
+                nonce(nonce) {}
+
+    // Exactly 80 bytes / consume them from `s`.
+    explicit BlockHeader(std::span<const uint8_t> serialized_header);
+    template <InStream Stream>
+    explicit BlockHeader(Stream& s) { Unserialize(s); }
+
+    std::vector<uint8_t> Serialize() const;
+
+    int32_t        GetVersion()    const { return version; }
+    const Hash256& GetPrevBlock()  const { return prev_block; }
+    const Hash256& GetMerkleRoot() const { return merkle_root; }
+    uint32_t       GetTime()       const { return time; }
+    uint32_t       GetBits()       const { return bits; }
+    uint32_t       GetNonce()      const { return nonce; }
+
+    // Builder, chainable.
+    BlockHeader& SetVersion(int32_t version);
+    BlockHeader& SetPrevBlock(const Hash256& prev_block);
+    BlockHeader& SetMerkleRoot(const Hash256& merkle_root);
+    BlockHeader& SetTime(uint32_t time);
+    BlockHeader& SetBits(uint32_t bits);
+    BlockHeader& SetNonce(uint32_t nonce);
+
+    // hash256 of the 80 bytes, serialized order.
+    const Hash256& GetHash() const;
+
+    template <OutStream Stream>
+    void Serialize(Stream& s) const {
+        ::SerializeMany(s, version, prev_block, merkle_root, time, bits, nonce);
+    }
+    template <InStream Stream>
+    void Unserialize(Stream& s) {
+        ::UnserializeMany(s, version, prev_block, merkle_root, time, bits, nonce);
+        hash.reset();
+    }
+
+private:
+    int32_t  version = 0;
+    Hash256  prev_block{};
+    Hash256  merkle_root{};
+    uint32_t time  = 0;
+    uint32_t bits  = 0;
+    uint32_t nonce = 0;
+
+    mutable std::optional<Hash256> hash;
+};
+
+template <>
+struct FixedSize<BlockHeader> { static constexpr size_t value = 80; };
@@ -0,0 +1,61 @@
+#include "ChainParams.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+
+// Hashes below are written in display order.
+static Hash256 FromDisplayHex(const std::string& hex) {
+    Hash256 hash;
+    auto bytes = hex2bytes(hex);
+    std::reverse_copy(bytes.begin(), bytes.end(), hash.begin());
+    return hash;
+}
+
+// All three genesis blocks have the same coinbase, hence merkle root.
+static BlockHeader Genesis(uint32_t time, uint32_t bits, uint32_t nonce) {
+    return BlockHeader(1, Hash256{},
+        FromDisplayHex("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b"),
+        time, bits, nonce);
+}
+
+const ChainParams& ChainParams::Main() {
+    static const ChainParams params = [] {
+        ChainParams main;
+        main.genesis   = Genesis(1231006505, 0x1d00ffff, 2083236893);
+        main.pow_limit = ~Uint256() >> 32; // 00000000ffff...ff
+        main.bip34_height = 227931;
+        main.bip66_height = 363725;
+        main.bip65_height = 388381;
+        return main;
+    }();
+    return params;
+}
+
+const ChainParams& ChainParams::Testnet() {
+    static const ChainParams params = [] {
+        ChainParams testnet;
+        testnet.genesis   = Genesis(1296688602, 0x1d00ffff, 414098458);
+        testnet.pow_limit = ~Uint256() >> 32;
+        testnet.bip34_height = 21111;
+        testnet.bip66_height = 330776;
+        testnet.bip65_height = 581885;
+        testnet.pow_allow_min_difficulty_blocks = true;
+        return testnet;
+    }();
+    return params;
+}
+
+const ChainParams& ChainParams::Regtest() {
+    static const ChainParams params = [] {
+        ChainParams regtest;
+        regtest.genesis   = Genesis(1296688602, 0x207fffff, 2);
+        regtest.pow_limit = ~Uint256() >> 1;  // 7fffff...ff
+        regtest.bip34_height = 500;
+        regtest.bip66_height = 1251;
+        regtest.bip65_height = 1351;
+        regtest.pow_allow_min_difficulty_blocks = true;
+        regtest.pow_no_retargeting              = true;
+        return regtest;
+    }();
+    return params;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "BlockHeader.hpp"
+#include "Uint256.hpp"
+
+#include <cstdint>
+
+// Consensus parameters of a network, as far as headers are concerned.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/chainparams.cpp
+struct ChainParams {
+    BlockHeader genesis;
+    Uint256     pow_limit;                       // easiest target allowed
+    int64_t     pow_target_spacing  = 10 * 60;   // seconds per block
+    int64_t     pow_target_timespan = 14 * 24 * 60 * 60;
+    bool        pow_allow_min_difficulty_blocks = false; // testnet's 20 minute rule
+    bool        pow_no_retargeting              = false; // regtest
+    // Heights from which headers must have version >= 2, 3, 4.
+    int64_t     bip34_height = 0;
+    int64_t     bip66_height = 0;
+    int64_t     bip65_height = 0;
+
+    // Blocks between retargets, 2016.
+    int64_t DifficultyAdjustmentInterval() const { return pow_target_timespan / pow_target_spacing; }
+
+    static const ChainParams& Main();
+    static const ChainParams& Testnet();
+    static const ChainParams& Regtest();
+};
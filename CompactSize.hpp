@@ -1,28 +1,92 @@
 #pragma once
 
-#include "utils.hpp"
+#include "endian.hpp"
 
-#include <iostream>
+#include <span>
 #include <vector>
-#include <limits>
-#include <cstring>
+#include <cstdint>
+#include <stdexcept>
 
-// Format used to serialize the size of some transaction elements
+/* Format used to serialize the size of some transaction elements.
+   https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/serialize.h
+
+       size < 0xfd          1 byte
+       size <= 0xffff       0xfd + 2 bytes LE
+       size <= 0xffffffff   0xfe + 4 bytes LE
+       larger               0xff + 8 bytes LE
+
+   Only the shortest encoding is valid, and like Core decoding refuses
+   sizes above MAX_COMPACT_SIZE. Free functions below work on caller
+   buffers and are constexpr; the stream versions are in serialize.hpp. */
+
+static const uint64_t MAX_COMPACT_SIZE = 0x02000000;
+
+// Encoded length of `size`, prefix included.
+constexpr size_t GetCompactSizeSize(uint64_t size) {
+    return size < 0xfd ? 1 : size <= 0xffff ? 3 : size <= 0xffffffff ? 5 : 9;
+}
+
+// Encoded length given the first byte, prefix included.
+constexpr size_t GetCompactSizeSizeFromPrefix(uint8_t prefix) {
+    return prefix < 0xfd ? 1 : prefix == 0xfd ? 3 : prefix == 0xfe ? 5 : 9;
+}
+
+// Write `size` at the start of `out`, returns how many bytes it took.
+constexpr size_t EncodeCompactSize(uint64_t size, std::span<uint8_t> out) {
+    size_t length = GetCompactSizeSize(size);
+    if (out.size() < length)
+        throw std::runtime_error("EncodeCompactSize: buffer too small");
+    if (length == 1) {
+        out[0] = (uint8_t)size;
+        return 1;
+    }
+    if (length == 3) {
+        out[0] = 0xfd;
+        WriteLE16(&out[1], (uint16_t)size);
+    } else if (length == 5) {
+        out[0] = 0xfe;
+        WriteLE32(&out[1], (uint32_t)size);
+    } else {
+        out[0] = 0xff;
+        WriteLE64(&out[1], size);
+    }
+    return length;
+}
+
+// Read the size at the start of `in` into `size`, returns how many bytes it
+// took. Throws on truncated, non-canonical or oversized encodings.
+constexpr size_t DecodeCompactSize(std::span<const uint8_t> in, uint64_t& size) {
+    if (in.empty())
+        throw std::runtime_error("DecodeCompactSize: unexpected end of data");
+    size_t length = GetCompactSizeSizeFromPrefix(in[0]);
+    if (in.size() < length)
+        throw std::runtime_error("DecodeCompactSize: unexpected end of data");
+    uint64_t value = length == 1 ? in[0]
+                   : length == 3 ? ReadLE16(&in[1])
+                   : length == 5 ? ReadLE32(&in[1])
+                   :               ReadLE64(&in[1]);
+    if (GetCompactSizeSize(value) != length)
+        throw std::runtime_error("non-canonical ReadCompactSize()");
+    if (value > MAX_COMPACT_SIZE)
+        throw std::runtime_error("ReadCompactSize(): size too large");
+    size = value;
+    return length;
+}
+
+// Value wrapper over the functions above.
 class CompactSize {
 public:
-    CompactSize(const uint64_t& size);
+    constexpr CompactSize(uint64_t size): size_value(size) {}
+    constexpr explicit CompactSize(std::span<const uint8_t> bytes) {
+        DecodeCompactSize(bytes, size_value);
+    }
 
-    CompactSize(const std::vector<uint8_t>& bytes);
+    constexpr uint64_t   GetInt()  const { return size_value; }
+    constexpr size_t     GetSize() const { return GetCompactSizeSize(size_value); }
+    std::vector<uint8_t> GetBytes() const;
 
-    uint64_t             GetInt() const;
-    std::vector<uint8_t> GetBytes();
+    static constexpr size_t GetSize(uint64_t size) { return GetCompactSizeSize(size); }
 
 private:
-    std::vector<uint8_t> bytes;
-    uint64_t             size_value = 0;
-
-    void Encode(const uint64_t& size);
-    void Decode(const std::vector<uint8_t>& input_bytes);
-
-    size_t ExtractLength(const std::vector<uint8_t>& serialized_data) const;
+    uint64_t size_value = 0;
 };
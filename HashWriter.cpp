@@ -0,0 +1,52 @@
+#include "HashWriter.hpp"
+#include "endian.hpp"
+
+void HashWriter::Write(std::span<const uint8_t> bytes) {
+    size += bytes.size();
+    if (buffered) {
+        size_t fill = std::min(64 - buffered, bytes.size());
+        std::copy(bytes.begin(), bytes.begin() + fill, buffer.begin() + buffered);
+        buffered += fill;
+        bytes     = bytes.subspan(fill);
+        if (buffered < 64)
+            return;
+        Sha256::Transform(state, buffer.data(), 1);
+        buffered = 0;
+    }
+    // Whole blocks straight from `bytes`.
+    size_t blocks = bytes.size() / 64;
+    if (blocks)
+        Sha256::Transform(state, bytes.data(), blocks);
+    std::copy(bytes.begin() + 64*blocks, bytes.end(), buffer.begin());
+    buffered = bytes.size() - 64*blocks;
+}
+
+Hash256 HashWriter::GetHash() const {
+    // Padding: 0x80, zeros, the length in bits, on a copy so that writes can
+    // go on.
+    auto    digest = state;
+    uint8_t block[64];
+    std::copy(buffer.begin(), buffer.begin() + buffered, block);
+    std::fill(block + buffered, block + 64, 0);
+    block[buffered] = 0x80;
+    if (buffered >= 56) {
+        Sha256::Transform(digest, block, 1);
+        std::fill(block, block + 64, 0);
+    }
+    WriteBE64(block + 56, size * 8);
+    Sha256::Transform(digest, block, 1);
+
+    // Second SHA256 over the 32-byte digest, a single block.
+    std::fill(block, block + 64, 0);
+    for (int i = 0; i < 8; i++)
+        WriteBE32(block + 4*i, digest[i]);
+    block[32] = 0x80;
+    WriteBE32(block + 60, 256);
+    digest = Sha256::INIT;
+    Sha256::Transform(digest, block, 1);
+
+    Hash256 md;
+    for (int i = 0; i < 8; i++)
+        WriteBE32(md.data() + 4*i, digest[i]);
+    return md;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "serialize.hpp"
+#include "hashes.hpp"
+#include "sha256.hpp"
+
+#include <span>
+#include <array>
+#include <cstdint>
+#include <algorithm>
+
+// Stream feeding everything written to it into SHA256, so an object can be
+// hashed straight from its Serialize() without building the bytes first.
+// Compresses with Sha256::Transform, no OpenSSL context to set up per hash.
+class HashWriter {
+public:
+    void WriteBytes(std::span<const uint8_t> bytes) {
+        // Most fields are a few bytes, only buffered.
+        if (buffered + bytes.size() < 64) {
+            std::copy(bytes.begin(), bytes.end(), buffer.begin() + buffered);
+            buffered += bytes.size();
+            size     += bytes.size();
+        } else {
+            Write(bytes);
+        }
+    }
+
+    // hash256() of everything written so far, serialized order.
+    Hash256 GetHash() const;
+
+private:
+    std::array<uint32_t, 8> state = Sha256::INIT;
+    std::array<uint8_t, 64> buffer;
+    size_t                  buffered = 0; // bytes of `buffer` not compressed yet
+    uint64_t                size     = 0; // written in all
+
+    void Write(std::span<const uint8_t> bytes);
+};
+
+// hash256() of the serialization of `object`.
+template <typename T>
+Hash256 SerializeHash(const T& object) {
+    HashWriter hasher;
+    ::Serialize(hasher, object);
+    return hasher.GetHash();
+}
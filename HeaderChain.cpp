@@ -0,0 +1,190 @@
+#include "HeaderChain.hpp"
+#include "endian.hpp"
+#include "sha256.hpp"
+#include "pow.hpp"
+
+#include <ctime>
+#include <cstdio>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/chain.h#L21
+static const int64_t MAX_FUTURE_BLOCK_TIME = 2 * 60 * 60;
+
+// Headers hashed per task of the first phase.
+static const size_t HASH_BATCH = 1024;
+
+static void Reject(const std::string& reason) {
+    throw std::runtime_error(reason);
+}
+
+HeaderChain::HeaderChain(const ChainParams& params):
+    params(params), limit_bits(params.pow_limit.GetCompact()) {
+    auto& genesis = params.genesis;
+    nodes.push_back({genesis, genesis.GetHash(), GetBlockProof(genesis.GetBits()), 0, 0, genesis.GetBits()});
+    by_hash.emplace(genesis.GetHash(), 0);
+    chain.push_back(0);
+}
+
+size_t HeaderChain::AddHeaders(std::span<const BlockHeader> headers, ThreadPool* pool) {
+    std::vector<uint8_t> serialized(headers.size() * 80);
+    for (size_t i = 0; i < headers.size(); i++) {
+        auto bytes = headers[i].Serialize();
+        std::copy(bytes.begin(), bytes.end(), serialized.begin() + 80*i);
+    }
+    return AddHeaders(std::span<const uint8_t>(serialized), pool);
+}
+
+size_t HeaderChain::AddHeaders(std::span<const uint8_t> serialized_headers, ThreadPool* pool) {
+    if (serialized_headers.size() % 80)
+        throw std::runtime_error("HeaderChain: expected a multiple of 80 bytes");
+    size_t         n    = serialized_headers.size() / 80;
+    const uint8_t* data = serialized_headers.data();
+
+    // Phase 1: what doesn't depend on the chain.
+    std::vector<Hash256> hashes(n);
+    std::vector<uint8_t> pow_ok(n);
+    auto hash_batch = [&](size_t batch, size_t) {
+        size_t begin = batch * HASH_BATCH, end = std::min(n, begin + HASH_BATCH);
+        Sha256::Hash80(data + 80*begin, end - begin, hashes.data() + begin);
+        for (size_t i = begin; i < end; i++)
+            pow_ok[i] = CheckProofOfWork(hashes[i], ReadLE32(data + 80*i + 72), params);
+    };
+    size_t n_batches = (n + HASH_BATCH - 1) / HASH_BATCH;
+    if (pool)
+        pool->ParallelFor(n_batches, hash_batch);
+    else
+        for (size_t batch = 0; batch < n_batches; batch++)
+            hash_batch(batch, 0);
+
+    // Phase 2: linking, in order.
+    int64_t now   = std::time(nullptr);
+    size_t  added = 0;
+    nodes.reserve(nodes.size() + n);
+    by_hash.reserve(nodes.size() + n);
+    for (size_t i = 0; i < n; i++) {
+        if (by_hash.count(hashes[i]))
+            continue;
+        Add(BlockHeader(serialized_headers.subspan(80*i, 80)), hashes[i], pow_ok[i], now);
+        added++;
+    }
+    return added;
+}
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/validation.cpp#L3614
+void HeaderChain::Add(const BlockHeader& header, const Hash256& hash, bool pow_ok, int64_t now) {
+    if (!pow_ok)
+        Reject("high-hash");
+
+    auto found = by_hash.find(header.GetPrevBlock());
+    if (found == by_hash.end())
+        Reject("prev-blk-not-found");
+    uint32_t    parent = found->second;
+    const Node& prev   = nodes[parent];
+    int64_t     height = prev.height + 1;
+
+    if (header.GetBits() != GetNextWorkRequired(parent, header))
+        Reject("bad-diffbits");
+    if (header.GetTime() <= GetMedianTimePast(parent))
+        Reject("time-too-old");
+    if (header.GetTime() > now + MAX_FUTURE_BLOCK_TIME)
+        Reject("time-too-new");
+    int32_t version = header.GetVersion();
+    if ((version < 2 && height >= params.bip34_height) ||
+        (version < 3 && height >= params.bip66_height) ||
+        (version < 4 && height >= params.bip65_height)) {
+        char reason[32];
+        std::snprintf(reason, sizeof(reason), "bad-version(0x%08x)", (uint32_t)version);
+        Reject(reason);
+    }
+
+    if (header.GetBits() != proof_bits) {
+        proof_bits = header.GetBits();
+        proof      = GetBlockProof(proof_bits);
+    }
+    bool min_difficulty = params.pow_allow_min_difficulty_blocks &&
+                          height % params.DifficultyAdjustmentInterval() != 0 &&
+                          header.GetBits() == limit_bits;
+    Node node{header, hash, prev.chain_work + proof, parent, (uint32_t)height,
+              min_difficulty ? prev.last_bits : header.GetBits()};
+
+    uint32_t index = nodes.size();
+    nodes.push_back(std::move(node));
+    by_hash.emplace(hash, index);
+    if (nodes[index].chain_work > GetChainWork())
+        SetTip(index);
+}
+
+// Rewrites the best chain from `index` back to the fork point.
+void HeaderChain::SetTip(uint32_t index) {
+    chain.resize(nodes[index].height + 1);
+    for (uint32_t j = index; chain[nodes[j].height] != j; j = nodes[j].parent)
+        chain[nodes[j].height] = j;
+}
+
+uint32_t HeaderChain::GetAncestor(uint32_t index, uint32_t height) const {
+    while (nodes[index].height > height) {
+        // On the best chain, the rest is a lookup.
+        if (chain.size() > nodes[index].height && chain[nodes[index].height] == index)
+            return chain[height];
+        index = nodes[index].parent;
+    }
+    return index;
+}
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/chain.h#L293
+int64_t HeaderChain::GetMedianTimePast(uint32_t index) const {
+    uint32_t times[11];
+    size_t   n = 0;
+    for (;; index = nodes[index].parent) {
+        times[n++] = nodes[index].header.GetTime();
+        if (n == 11 || nodes[index].height == 0)
+            break;
+    }
+    std::sort(times, times + n);
+    return times[n / 2];
+}
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/pow.cpp#L13
+uint32_t HeaderChain::GetNextWorkRequired(uint32_t parent, const BlockHeader& header) const {
+    const Node& last     = nodes[parent];
+    int64_t     interval = params.DifficultyAdjustmentInterval();
+
+    if ((last.height + 1) % interval != 0) {
+        if (!params.pow_allow_min_difficulty_blocks)
+            return last.header.GetBits();
+        // Testnet: a block more than 20 minutes after the previous one may
+        // be at the minimum difficulty, the others keep the last real one.
+        if (header.GetTime() > last.header.GetTime() + params.pow_target_spacing * 2)
+            return limit_bits;
+        return last.last_bits;
+    }
+
+    // The period is 2015 blocks long, an off-by-one that is now consensus.
+    uint32_t first = GetAncestor(parent, last.height - (interval - 1));
+    return CalculateNextWorkRequired(last.header.GetBits(), last.header.GetTime(),
+                                     nodes[first].header.GetTime(), params);
+}
+
+const BlockHeader& HeaderChain::GetHeader(size_t height) const {
+    if (height >= chain.size())
+        throw std::runtime_error("HeaderChain: no header at height " + std::to_string(height));
+    return nodes[chain[height]].header;
+}
+
+const Hash256& HeaderChain::GetHash(size_t height) const {
+    if (height >= chain.size())
+        throw std::runtime_error("HeaderChain: no header at height " + std::to_string(height));
+    return nodes[chain[height]].hash;
+}
+
+std::optional<size_t> HeaderChain::FindHeight(const Hash256& hash) const {
+    auto found = by_hash.find(hash);
+    if (found == by_hash.end())
+        return std::nullopt;
+    uint32_t height = nodes[found->second].height;
+    if (height >= chain.size() || chain[height] != found->second)
+        return std::nullopt;
+    return height;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "BlockHeader.hpp"
+#include "ChainParams.hpp"
+#include "ThreadPool.hpp"
+#include "Uint256.hpp"
+#include "hashes.hpp"
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+/* Headers-first view of a chain: every header received (the best chain and
+   forks), each checked the way Core accepts a header before its block
+   (https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/validation.cpp#L3662):
+
+       high-hash            hash above the nBits target, or nBits invalid /
+                            above the network's limit
+       prev-blk-not-found   unknown parent
+       bad-diffbits         nBits not the expected difficulty (retarget every
+                            2016 blocks, testnet's 20 minute rule)
+       time-too-old         time not after the median of the last 11
+       time-too-new         more than 2 hours ahead of the local clock
+       bad-version(0x...)   version below 2, 3, 4 after BIP34, 66, 65
+
+   Checkpoints and the assumed chain work Core also enforces aren't.
+
+   The best chain is the one with the most cumulative work (first seen wins
+   a tie), switching to a fork as soon as it has more. Ingestion is in two
+   phases: hashing and proof of work of the whole batch first, in SIMD lanes
+   (sha256.hpp) and over `pool` if given, then linking each header to its
+   parent in order. Not thread-safe. */
+class HeaderChain {
+public:
+    // Starts with the network's genesis block. `params` must outlive the chain.
+    explicit HeaderChain(const ChainParams& params = ChainParams::Main());
+
+    HeaderChain(const HeaderChain&)            = delete;
+    HeaderChain& operator=(const HeaderChain&) = delete;
+
+    // Adds `headers` in order, parents before children (a `headers` message,
+    // a chain dumped from a node), as objects or as consecutive 80-byte
+    // serialized ones. Known headers are skipped. Throws std::runtime_error
+    // with the reject reason on the first invalid header, those before it
+    // being kept. Returns how many were new.
+    size_t AddHeaders(std::span<const BlockHeader> headers, ThreadPool* pool = nullptr);
+    size_t AddHeaders(std::span<const uint8_t> serialized_headers, ThreadPool* pool = nullptr);
+
+    // Known headers, best chain and forks.
+    size_t HeaderCount() const { return nodes.size(); }
+
+    // Best chain.
+    size_t             GetHeight()    const { return chain.size() - 1; }
+    const BlockHeader& GetTip()       const { return nodes[chain.back()].header; }
+    const Uint256&     GetChainWork() const { return nodes[chain.back()].chain_work; }
+    const BlockHeader& GetHeader(size_t height) const;
+    const Hash256&     GetHash(size_t height)   const;
+
+    // Height of a known header, if it's on the best chain.
+    std::optional<size_t> FindHeight(const Hash256& hash) const;
+    bool                  Contains(const Hash256& hash) const { return by_hash.count(hash); }
+
+private:
+    struct Node {
+        BlockHeader header;
+        Hash256     hash;
+        Uint256     chain_work; // up to and including this header
+        uint32_t    parent;     // index in `nodes`, itself for the genesis block
+        uint32_t    height;
+        // nBits of the last header that isn't a testnet min-difficulty one,
+        // walking back to the last retarget.
+        uint32_t    last_bits;
+    };
+
+    const ChainParams&                                   params;
+    uint32_t                                             limit_bits; // pow_limit, compact
+    std::vector<Node>                                    nodes;
+    std::unordered_map<Hash256, uint32_t, Hash256Hasher> by_hash;
+    // Best chain, node index by height.
+    std::vector<uint32_t>                                chain;
+
+    // Last GetBlockProof(), nBits rarely change.
+    uint32_t proof_bits = 0;
+    Uint256  proof;
+
+    void     Add(const BlockHeader& header, const Hash256& hash, bool pow_ok, int64_t now);
+    void     SetTip(uint32_t index);
+    uint32_t GetAncestor(uint32_t index, uint32_t height) const;
+    int64_t  GetMedianTimePast(uint32_t index) const;
+    uint32_t GetNextWorkRequired(uint32_t parent, const BlockHeader& header) const;
+};
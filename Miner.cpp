@@ -0,0 +1,113 @@
+#include "Miner.hpp"
+#include "Uint256.hpp"
+#include "sha256.hpp"
+#include "endian.hpp"
+#include "merkle.hpp"
+
+#include <mutex>
+#include <chrono>
+#include <stdexcept>
+
+// Nonces per ThreadPool task, ~10 ms worth: Stop() and a block found by
+// another thread are noticed between tasks.
+static const uint64_t NONCES_PER_TASK = 1 << 16;
+
+std::optional<BlockHeader> Miner::Search(const BlockHeader& header, const ChainParams& params) {
+    bool negative, overflow;
+    Uint256 target = Uint256::FromCompact(header.GetBits(), &negative, &overflow);
+    if (negative || overflow || target == 0 || target > params.pow_limit)
+        throw std::runtime_error("Miner: invalid nBits");
+    uint32_t max_top = (uint32_t)(target >> 224).Low64();
+
+    auto serialized = header.Serialize();
+    auto midstate   = Sha256::INIT;
+    Sha256::Transform(midstate, serialized.data(), 1);
+
+    auto     start  = std::chrono::steady_clock::now();
+    uint32_t first  = header.GetNonce();
+    uint64_t total  = (1ull << 32) - first;
+    std::atomic<bool>       done = false;
+    std::mutex              mutex;
+    std::optional<uint32_t> found;
+
+    // Tasks are handed out in order and run to the end once started, so the
+    // nonce found is the lowest valid one whatever the number of threads.
+    pool.ParallelFor((total + NONCES_PER_TASK - 1) / NONCES_PER_TASK, [&](size_t task, size_t) {
+        if (done || stopping)
+            return;
+        uint64_t begin = task * NONCES_PER_TASK;
+        uint64_t left  = std::min(total, begin + NONCES_PER_TASK) - begin;
+        uint32_t nonce = first + (uint32_t)begin;
+        uint8_t  candidate_header[80];
+        std::copy(serialized.begin(), serialized.end(), candidate_header);
+
+        while (left) {
+            auto candidate = Sha256::ScanNonces(midstate, serialized.data() + 64, nonce, left, max_top);
+            uint64_t scanned = candidate ? *candidate - nonce + 1 : left;
+            hashes += scanned;
+            if (!candidate)
+                break;
+
+            Hash256 hash;
+            WriteLE32(candidate_header + 76, *candidate);
+            Sha256::Hash80(candidate_header, 1, &hash);
+            if (Uint256(hash) <= target) {
+                std::lock_guard lock(mutex);
+                if (!found || *candidate < *found)
+                    found = *candidate;
+                done = true;
+                return;
+            }
+            left -= scanned;
+            nonce = *candidate + 1;
+        }
+    });
+    nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    if (!found)
+        return std::nullopt;
+    BlockHeader mined = header;
+    return mined.SetNonce(*found);
+}
+
+std::optional<BlockHeader> Miner::MineHeader(const BlockHeader& header, const ChainParams& params) {
+    auto mined = Search(header, params);
+    if (mined)
+        blocks++;
+    stopping = false;
+    return mined;
+}
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/miner.cpp#L443
+bool Miner::MineBlock(Block& block, int32_t height, const ChainParams& params, uint64_t extra_nonce) {
+    if (block.GetTxs().empty())
+        throw std::runtime_error("Miner: block without coinbase");
+
+    BlockHeader    header = block.GetHeader();
+    CoinbaseBranch branch(block);
+    for (;; extra_nonce++) {
+        uint8_t extra[8];
+        WriteLE64(extra, extra_nonce);
+        Tx coinbase = block.GetTxs()[0];
+        coinbase.SetScriptSig(0, Script() << height << std::span<const uint8_t>(extra));
+        header.SetMerkleRoot(branch.GetRoot(coinbase.GetTxId()));
+        block.SetTx(0, std::move(coinbase));
+
+        if (auto mined = Search(header, params)) {
+            block.SetHeader(*mined);
+            blocks++;
+            return true;
+        }
+        if (stopping) {
+            block.SetHeader(header);
+            stopping = false;
+            return false;
+        }
+        header.SetNonce(0);
+    }
+}
+
+Miner::Stats Miner::GetStats() const {
+    return {hashes, nanoseconds / 1e9, blocks};
+}
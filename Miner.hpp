@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Block.hpp"
+#include "BlockHeader.hpp"
+#include "ChainParams.hpp"
+#include "ThreadPool.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+/* CPU block producer for regtest and test networks, no pool or external
+   service. A header's nonce space is split over `pool`, each thread starting
+   from the midstate of the header's first 64 bytes (the nonce is in the
+   last 16) and scanning nonces in SIMD lanes / interleaved SHA-NI streams
+   (Sha256::ScanNonces). Only the nonces whose hash passes a check of its
+   top 32 bits against the target are hashed and checked in full.
+
+   When the nonces run out, MineBlock() moves to the next extranonce: the
+   coinbase's scriptSig is rewritten, which changes its txid and the merkle
+   root, hence the whole header. The root comes from the coinbase's merkle
+   branch (merkle.hpp), log2(n) hashes rather than the whole tree.
+
+   One Mine* call at a time. Stop() and GetStats() may be called from other
+   threads. */
+class Miner {
+public:
+    explicit Miner(ThreadPool& pool): pool(pool) {}
+
+    Miner(const Miner&)            = delete;
+    Miner& operator=(const Miner&) = delete;
+
+    // `header` with a nonce from its own up (2^32 - GetNonce() of them)
+    // putting its hash within its nBits target, nothing if there is none or
+    // Stop() was called. nBits above `params`' limit are refused.
+    std::optional<BlockHeader> MineHeader(const BlockHeader& header,
+                                          const ChainParams& params = ChainParams::Main());
+
+    // Mines `block` in place, rolling extranonces from `extra_nonce` up: the
+    // coinbase's scriptSig becomes <height> <extranonce as 8 bytes LE>
+    // (BIP34's height first, then a fixed-size push so that the block's size
+    // doesn't change). The first extranonce's nonces start from the
+    // header's, the next ones' from 0. False if Stop() was called, `block`
+    // then holds the last extranonce tried.
+    bool MineBlock(Block& block, int32_t height, const ChainParams& params = ChainParams::Main(),
+                   uint64_t extra_nonce = 0);
+
+    // Makes the current Mine* call return, or the next one if none is
+    // running.
+    void Stop() { stopping = true; }
+
+    // Over all calls: hashes tried and time spent.
+    struct Stats {
+        uint64_t hashes  = 0;
+        double   seconds = 0;
+        uint64_t blocks  = 0; // found, by either function
+
+        double GetHashrate() const { return seconds > 0 ? hashes / seconds : 0; }
+    };
+    Stats GetStats() const;
+
+private:
+    ThreadPool&           pool;
+    std::atomic<bool>     stopping    = false;
+    std::atomic<uint64_t> hashes      = 0;
+    std::atomic<uint64_t> nanoseconds = 0;
+    std::atomic<uint64_t> blocks      = 0;
+
+    std::optional<BlockHeader> Search(const BlockHeader& header, const ChainParams& params);
+};
@@ -0,0 +1,6 @@
+#include "OutPoint.hpp"
+#include "utils.hpp"
+
+std::string OutPoint::ToString() const {
+    return toDisplayHex(txid) + ":" + std::to_string(n);
+}
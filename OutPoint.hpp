@@ -0,0 +1,46 @@
+#pragma once
+
+#include "serialize.hpp"
+#include "hashes.hpp"
+#include "endian.hpp"
+
+#include <string>
+#include <compare>
+#include <functional>
+#include <type_traits>
+
+// Reference to a transaction output: the txid (serialized order) and the
+// output's index. 36 plain bytes, no allocation, ordered like Core's
+// COutPoint (txid bytes, then index) and hashable for unordered containers.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/primitives/transaction.h#L26
+struct OutPoint {
+    Hash256  txid{};
+    uint32_t n = 0;
+
+    auto operator<=>(const OutPoint&) const = default;
+
+    // What a coinbase input points to: no txid, index 0xffffffff.
+    bool IsNull() const { return n == 0xffffffff && txid == Hash256{}; }
+
+    // "<txid in display order>:<n>", as written by block explorers.
+    std::string ToString() const;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const { ::SerializeMany(s, txid, n); }
+    template <typename Stream>
+    void Unserialize(Stream& s) { ::UnserializeMany(s, txid, n); }
+};
+
+static_assert(std::is_trivially_copyable_v<OutPoint>);
+
+template <>
+struct FixedSize<OutPoint> { static constexpr size_t value = 32 + 4; };
+
+// txids are already uniformly distributed, 8 of their bytes make a good hash.
+// Not salted, so not meant for maps fed by untrusted peers.
+template <>
+struct std::hash<OutPoint> {
+    size_t operator()(const OutPoint& outpoint) const noexcept {
+        return ReadLE64(outpoint.txid.data()) ^ (outpoint.n * 0x9e3779b97f4a7c15ull);
+    }
+};
@@ -0,0 +1,6 @@
+#include "Reader.hpp"
+#include "serialize.hpp"
+
+uint64_t Reader::ReadCompactSize() {
+    return ::ReadCompactSize(*this);
+}
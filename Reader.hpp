@@ -0,0 +1,48 @@
+#pragma once
+
+#include "serialize.hpp"
+
+#include <span>
+#include <cstdint>
+#include <stdexcept>
+
+// Forward-only cursor over serialized bytes. Nothing is copied, reads hand
+// out views into the underlying buffer (which must outlive them) and throw
+// std::runtime_error instead of reading past its end.
+class Reader {
+public:
+    explicit Reader(std::span<const uint8_t> data): data(data) {}
+
+    // Next `n` bytes, in place.
+    std::span<const uint8_t> ReadBytes(size_t n) {
+        Require(n);
+        auto bytes = data.subspan(pos, n);
+        pos += n;
+        return bytes;
+    }
+
+    // Little-endian integer of sizeof(T) bytes.
+    template <typename T>
+    T Read() {
+        T value;
+        ::Unserialize(*this, value);
+        return value;
+    }
+
+    // CompactSize length prefix, see CompactSize.hpp.
+    uint64_t ReadCompactSize();
+
+    size_t                   Position()  const { return pos; }
+    size_t                   Remaining() const { return data.size() - pos; }
+    bool                     Empty()     const { return pos == data.size(); }
+    std::span<const uint8_t> Rest()      const { return data.subspan(pos); }
+
+private:
+    std::span<const uint8_t> data;
+    size_t                   pos = 0;
+
+    void Require(size_t n) const {
+        if (n > data.size() - pos)
+            throw std::runtime_error("Reader: unexpected end of data");
+    }
+};
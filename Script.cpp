@@ -1,143 +1,186 @@
 #include "Script.hpp"
 #include "hashes.hpp"
+#include "endian.hpp"
+
+#include <functional>
 
 ////////////////////////////// SCRIPT EXECUTION /////////////////////////////
 
 // Run the script and return last element of stack.
-std::vector<uint8_t> Script::Run() {
-    if (exec.empty())
-        throw std::runtime_error("Run: cannot run empty script");
-    if (exec.size() > MAX_SCRIPT_SIZE)
-        throw std::runtime_error("Run: script size > 10000 bytes");
-    
+ScriptResult<std::vector<uint8_t>> Script::Run(ScriptEngine engine) {
+    auto error = Execute(exec, engine, threaded);
+
+    // Check and clean up.
+    std::vector<uint8_t> result;
+    if (error == SCRIPT_ERR_OK && stack.empty())
+        error = SCRIPT_ERR_EVAL_FALSE;
+    if (error == SCRIPT_ERR_OK)
+        result = std::move(stack.back());
+    stack.clear();
+    alt_stack.clear();
+    run_this.clear();
+    if (error != SCRIPT_ERR_OK)
+        return error;
+    return result;
+}
+
+ScriptError Script::Eval(std::span<const uint8_t> script, std::vector<std::vector<uint8_t>>& io_stack,
+                         ScriptEngine engine) {
+    threaded.clear(); // the previous script's
+    stack.swap(io_stack);
+    auto error = Execute(script, engine, threaded);
+    stack.swap(io_stack);
+    stack.clear();
+    alt_stack.clear();
+    run_this.clear();
+    return error;
+}
+
+ScriptError Script::Execute(std::span<const uint8_t> script, ScriptEngine engine,
+                            std::vector<ThreadedOp>& code) {
+    // Reject anything statically invalid before running a single OP.
+    auto error = Analyze(script).GetError();
+
     // All OPs should be executed by default.
-    run_this.push(true);
-    
+    alt_stack.clear();
+    run_this.clear();
+    run_this_false = 0;
+
     // Do the thing
-    Interpreter(exec);
-    
-    // Check and clean up.    
-    if(!stack.empty()) {
-        auto result = stack.back();
-        stack.clear();
-        alt_stack.clear();
-        run_this = std::stack<bool>(); // might not be necessary
-        return result;
-    } else throw std::runtime_error("Run: script resulted in empty stack");
+    if (error == SCRIPT_ERR_OK)
+        error = (engine == ScriptEngine::Threaded) ? ThreadedInterpreter(script, code)
+                                                   : Interpreter(script);
+    return error;
+}
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/script/interpreter.cpp#L1943
+ScriptError Script::Verify(const Script& script_sig, const Script& script_pubkey,
+                           uint32_t flags, ScriptEngine engine) {
+    if ((flags & SCRIPT_VERIFY_SIGPUSHONLY) && !script_sig.IsPushOnly())
+        return SCRIPT_ERR_SIG_PUSHONLY;
+
+    Script interpreter;
+    std::vector<std::vector<uint8_t>> stack, stack_copy;
+    if (auto error = interpreter.Eval(script_sig.exec, stack, engine))
+        return error;
+    if (flags & SCRIPT_VERIFY_P2SH)
+        stack_copy = stack;
+    if (auto error = interpreter.Eval(script_pubkey.exec, stack, engine))
+        return error;
+    if (stack.empty() || !interpreter.CastAsBool(stack.back()))
+        return SCRIPT_ERR_EVAL_FALSE;
+
+    // The scriptSig's last push is the serialized redeem script, run it on
+    // what the scriptSig left below it.
+    if ((flags & SCRIPT_VERIFY_P2SH) && script_pubkey.IsPayToScriptHash()) {
+        if (!script_sig.IsPushOnly())
+            return SCRIPT_ERR_SIG_PUSHONLY;
+        stack.swap(stack_copy);
+        auto redeem_script = std::move(stack.back()); // not empty, it was just hashed
+        stack.pop_back();
+        if (auto error = interpreter.Eval(redeem_script, stack, engine))
+            return error;
+        if (stack.empty() || !interpreter.CastAsBool(stack.back()))
+            return SCRIPT_ERR_EVAL_FALSE;
+    }
+
+    // Core only allows CLEANSTACK along with P2SH.
+    if ((flags & SCRIPT_VERIFY_CLEANSTACK) && (flags & SCRIPT_VERIFY_P2SH)
+                                            && stack.size() != 1)
+        return SCRIPT_ERR_CLEANSTACK;
+
+    return SCRIPT_ERR_OK;
 }
 
-void Script::Interpreter(const std::vector<uint8_t>& script) {
-    
-    using Iterator = std::vector<uint8_t>::const_iterator;
-
-    auto num_op = 0;
-
-    // Fetch data and increment script iterator.
-    auto fetch_data = [](const size_t& data_size, Iterator& script_it) {
-        std::vector<uint8_t> data;
-        data.reserve(data_size);
-        for (size_t i = 0; i < data_size; i++)
-            data.push_back(*(++script_it));
-        return data;
-    };
-
-    // Skip conditional block and increment script iterator.
-    auto skip_block = [&script, fetch_data](Iterator& script_it) {
-        auto nested_if = 0;
-        for (;script_it != script.end(); script_it++) {
-            if (*script_it >= 0x01 && *script_it <= 0x4b) // skip data
-                fetch_data(*script_it, script_it);
-            else if (*script_it == OP_PUSHDATA1) // skip data
-                fetch_data(*script_it, ++script_it);
-            else if (*script_it == OP_PUSHDATA2) { // skip data
-                std::vector<uint8_t> size_bytes{*(++script_it), *(++script_it)};
-                ScriptNum size(size_bytes);
-                if (size > MAX_STACK_ELEMENT_SIZE)
-                    throw std::runtime_error("Interpreter: data size > 520 bytes");
-                fetch_data(ScriptNum(size).GetInt(), script_it);
-            }
-            if (*script_it == OP_IF || *script_it == OP_NOTIF) nested_if++;
-            if ((*script_it == OP_ELSE || *script_it == OP_ENDIF) && !nested_if)
-                return;
-            if (*script_it == OP_ENDIF && nested_if) nested_if--;
-        } throw std::runtime_error("Interpreter: missing op_endif");
-    };
+ScriptError Script::Interpreter(std::span<const uint8_t> script) {
+
+    const uint8_t* pc  = script.data();
+    const uint8_t* end = script.data() + script.size();
+    const uint8_t* data;
+    uint32_t       data_size;
+    uint8_t        opcode;
+    auto           num_op = 0;
 
     // Interpreter main loop.
-    for (auto script_it = script.begin(); script_it != script.end(); script_it++) {
-        auto op_name = ScriptInterface[(OpEnum)*script_it].first;
-        auto op_ptr  = ScriptInterface[(OpEnum)*script_it].second;
-        if (op_ptr != nullptr && ++num_op > MAX_OP_PER_SCRIPT)
-            throw std::runtime_error("Interpreter: reached OPs limit (201)");
-        if (stack.size() > MAX_STACK_SIZE)
-            throw std::runtime_error("Interpreter: reached max stack size (1000)");
-        if (!op_name.empty())
-            std::cout << op_name << std::endl;
-
-        // For conditional blocks that should be evaluated.
-        if ((*script_it == OP_IF || *script_it == OP_NOTIF) && run_this.top()) {
-            CheckStack(1, "conditional_block:");
-            if (CastAsBool(stack.back())) // Evaluate condition.
-                 run_this.push(*script_it == OP_IF    ? true : false);
-            else run_this.push(*script_it == OP_NOTIF ? true : false);
-            stack.pop_back(); // Pop condition.
-            if (!run_this.top()) skip_block(++script_it); // Skip block when cond == false.
+    while (pc < end) {
+        if (!GetOp(pc, end, opcode, data, data_size))
+            return SCRIPT_ERR_BAD_OPCODE;
+        if (data_size > MAX_STACK_ELEMENT_SIZE)
+            return SCRIPT_ERR_PUSH_SIZE;
+        if (opcode > OP_16 && ++num_op > MAX_OP_PER_SCRIPT)
+            return SCRIPT_ERR_OP_COUNT;
+
+        bool run = run_this_false == 0;
+
+        auto op = ScriptInterface.find((OpEnum)opcode);
+        if (trace && run && op != ScriptInterface.end())
+            std::cout << op->second.first << std::endl;
+
+        if (run && opcode <= OP_PUSHDATA4) { // data push
+            stack.emplace_back(data, data + data_size);
+        } else if (opcode == OP_IF || opcode == OP_NOTIF) {
+            bool value = false;
+            if (run) { // Evaluate condition.
+                if (!CheckStack(1))
+                    return SCRIPT_ERR_UNBALANCED_CONDITIONAL;
+                value = CastAsBool(stack.back()) == (opcode == OP_IF);
+                stack.pop_back(); // Pop condition.
+            }
+            run_this.push_back(value);
+            run_this_false += !value;
+        } else if (opcode == OP_ELSE || opcode == OP_ENDIF) {
+            // These OPs shouldn't appear if we're not in a conditional block.
+            if (run_this.empty())
+                return SCRIPT_ERR_UNBALANCED_CONDITIONAL;
+            run_this_false -= !run_this.back();
+            if (opcode == OP_ELSE) {
+                run_this.back() = !run_this.back();
+                run_this_false += !run_this.back();
+            } else run_this.pop_back();
+        } else if (run || opcode == OP_VERIF || opcode == OP_VERNOTIF) {
+            // Run all other OPs.
+            if (op == ScriptInterface.end())
+                return SCRIPT_ERR_BAD_OPCODE;
+            if (auto error = std::invoke(op->second.second, this))
+                return error;
         }
 
-        // These OPs shouldn't appear if we're not in a conditional block.
-        if (*script_it == OP_ELSE || *script_it == OP_ENDIF) {
-            if (run_this.size() != 1) {
-                if (*script_it == OP_ELSE)
-                    run_this.top() = !run_this.top();
-                else if (*script_it == OP_ENDIF)
-                    run_this.pop();
-            } else throw std::runtime_error("Interpreter: missing op_if");
-        }
+        if (stack.size() + alt_stack.size() > MAX_STACK_SIZE)
+            return SCRIPT_ERR_STACK_SIZE;
+    }
 
-        // Run all other OPs.
-        if (run_this.top()) {
-            if (*script_it >= 0x01 && *script_it <= 0x4b) // data bytelength
-                stack.push_back(fetch_data(*script_it, script_it));
-            else if (*script_it == OP_PUSHDATA1) // next byte = data bytelength
-                stack.push_back(fetch_data(*script_it, ++script_it));
-            else if (*script_it == OP_PUSHDATA2) { // next two bytes = data bytelength
-                std::vector<uint8_t> size_bytes{*(++script_it), *(++script_it)};
-                ScriptNum size(size_bytes);
-                if (size > MAX_STACK_ELEMENT_SIZE)
-                    throw std::runtime_error("Interpreter: data size > 520 bytes");
-                stack.push_back(fetch_data(ScriptNum(size).GetInt(), script_it));
-            } else if (op_ptr != nullptr) std::invoke(op_ptr, this); //(this->*op_ptr)(); // run normal operations
-            else InvalidOperation(__func__);
-        }
+    if (!run_this.empty())
+        return SCRIPT_ERR_UNBALANCED_CONDITIONAL;
+
+    if (trace) {
+        std::cout << "\nSTACK\n";
+        for (auto& s: stack)
+            std::cout << " - [" << toHex(s) << "] " << s.size() << std::endl;
+        std::cout << "END_STACK\n";
     }
-    
-    if (run_this.size() > 1)
-        throw std::runtime_error("Interpreter: missing op_endif");
 
-    std::cout << "\nSTACK\n";
-    for (auto& s: stack)
-        std::cout << " - [" << toHex(s) << "] " << s.size() << std::endl;
-    std::cout << "END_STACK\n";
+    return SCRIPT_ERR_OK;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////// SCRIPT INSERTION //////////////////////////////
 
-Script& Script::operator<<(const int32_t& n) {
-    ScriptNum num(n);
-    exec.push_back((uint8_t)num.GetBytes().size());
-    for (auto& b: num.GetBytes())
-        exec.push_back(b);
+Script& Script::operator<<(const int32_t& n) & {
+    auto num = ScriptNum(n).Encode();
+    exec.push_back(num.size);
+    exec.insert(exec.end(), num.begin(), num.end());
+    threaded.clear();
     return *this;
 }
 
-Script& Script::operator<<(const OpEnum& op) {
+Script& Script::operator<<(const OpEnum& op) & {
     exec.push_back((uint8_t)op);
+    threaded.clear();
     return *this;
 }
 
-Script& Script::operator<<(const std::vector<uint8_t>& data) {
+Script& Script::operator<<(std::span<const uint8_t> data) & {
     size_t size = data.size();
     
     if (size <= 75)
@@ -146,14 +189,14 @@ Script& Script::operator<<(const std::vector<uint8_t>& data) {
         exec.push_back(OpEnum::OP_PUSHDATA1);
         exec.push_back((uint8_t)size);
     } else if (size >= 256 && size <= MAX_STACK_ELEMENT_SIZE) {
-        exec.push_back(OpEnum::OP_PUSHDATA2);
-        for (auto& byteLE: ScriptNum(size).GetBytes())
-            exec.push_back(byteLE);
+        uint8_t push[3] = {OpEnum::OP_PUSHDATA2};
+        WriteLE16(push + 1, (uint16_t)size);
+        exec.insert(exec.end(), push, push + 3);
     } else throw std::runtime_error("data size > 520 bytes");
     
-    for (auto& byte: data)
-        exec.push_back(byte);
+    exec.insert(exec.end(), data.begin(), data.end());
 
+    threaded.clear();
     return *this;
 }
 
@@ -161,98 +204,123 @@ Script& Script::operator<<(const std::vector<uint8_t>& data) {
 
 ////////////////////////////// HELPER FUNCTIONS //////////////////////////////
 
-bool Script::CastAsBool(std::vector<uint8_t> bytes) const {
-    return std::find_if(bytes.begin(), bytes.end(), 
-        [](uint8_t x) { return x != 0x00; }) 
-        != bytes.end();
+bool Script::GetOp(const uint8_t*& pc, const uint8_t* end, uint8_t& opcode,
+                   const uint8_t*& data, uint32_t& data_size) {
+    if (pc >= end)
+        return false;
+    opcode    = *pc++;
+    data_size = 0;
+    if (opcode <= OP_PUSHDATA4) {
+        if (opcode < OP_PUSHDATA1)
+            data_size = opcode;
+        else {
+            size_t size_bytes = opcode == OP_PUSHDATA1 ? 1
+                              : opcode == OP_PUSHDATA2 ? 2 : 4;
+            if ((size_t)(end - pc) < size_bytes)
+                return false;
+            data_size = size_bytes == 1 ? pc[0]
+                      : size_bytes == 2 ? ReadLE16(pc) : ReadLE32(pc);
+            pc += size_bytes;
+        }
+        if ((size_t)(end - pc) < data_size)
+            return false;
+    }
+    data = pc;
+    pc  += data_size;
+    return true;
 }
 
-void Script::CheckStack(size_t n, const char* _func_) const{
-    size_t size = stack.size();
-    if (size < n) {
-        std::stringstream error;
-        error << _func_ << ": ";
-        if (size == 0) error << "stack empty";
-        else error << "stack size < " << n;
-        throw std::runtime_error(error.str());
-    }
+bool Script::IsPushOnly() const {
+    auto analysis = Analyze();
+    return analysis.push_only && !analysis.truncated;
 }
 
-void Script::CheckAltStack(size_t n, const char* _func_) const {
-    size_t size = alt_stack.size();
-    if (size < n) {
-        std::stringstream error;
-        error << _func_ << ": ";
-        if (size == 0) error << "alt-stack empty";
-        else error << "alt-stack size < " << n;
-        throw std::runtime_error(error.str());
-    }
+// OP_HASH160 <20 bytes> OP_EQUAL
+bool Script::IsPayToScriptHash() const {
+    return exec.size() == 23
+        && exec[0]  == OP_HASH160
+        && exec[1]  == 0x14
+        && exec[22] == OP_EQUAL;
+}
+
+// Anything but (negative) zero is true.
+bool Script::CastAsBool(const std::vector<uint8_t>& bytes) const {
+    for (size_t i = 0; i < bytes.size(); i++)
+        if (bytes[i] != 0x00)
+            return !(i == bytes.size()-1 && bytes[i] == 0x80);
+    return false;
+}
+
+// Decode the stack element `depth` back from the top (1 = top) as a ScriptNum.
+// Stack size must be checked first.
+bool Script::PeekNum(size_t depth, ScriptNum& num) const {
+    return ScriptNum::Parse(stack.end()[-depth], num);
 }
 
-void Script::DisabledOperation(const char* _func_) const {
-    std::stringstream error;
-    error << _func_ << ": operation disabled";
-    throw std::runtime_error(error.str());
+void Script::PushNum(const ScriptNum::Bytes& bytes) {
+    stack.emplace_back(bytes.begin(), bytes.end());
 }
 
-void Script::InvalidOperation(const char* _func_) const {
-    std::stringstream error;
-    error << _func_ << ": invalid operation";
-    throw std::runtime_error(error.str());
+// Replace the top n stack elements by num, reusing the deepest one's storage.
+void Script::ReplaceNum(size_t n, const ScriptNum& num) {
+    auto bytes = num.Encode();
+    stack.resize(stack.size() - (n-1));
+    stack.back().assign(bytes.begin(), bytes.end());
 }
 
 ////////////////////////////// SCRIPT OPERATIONS /////////////////////////////
 
 ///////////////////////////////// CONSTANTS //////////////////////////////////
 
-void Script::op_false() { op_0(); }
-void Script::op_true()  { op_1(); }
-
-void Script::op_0()  { stack.push_back(ScriptNum(0).GetBytes());  } 
-void Script::op_1()  { stack.push_back(ScriptNum(1).GetBytes());  }
-void Script::op_2()  { stack.push_back(ScriptNum(2).GetBytes());  }
-void Script::op_3()  { stack.push_back(ScriptNum(3).GetBytes());  }
-void Script::op_4()  { stack.push_back(ScriptNum(4).GetBytes());  }
-void Script::op_5()  { stack.push_back(ScriptNum(5).GetBytes());  }
-void Script::op_6()  { stack.push_back(ScriptNum(6).GetBytes());  }
-void Script::op_7()  { stack.push_back(ScriptNum(7).GetBytes());  }
-void Script::op_8()  { stack.push_back(ScriptNum(8).GetBytes());  }
-void Script::op_9()  { stack.push_back(ScriptNum(9).GetBytes());  }
-void Script::op_10() { stack.push_back(ScriptNum(10).GetBytes()); }
-void Script::op_11() { stack.push_back(ScriptNum(11).GetBytes()); }
-void Script::op_12() { stack.push_back(ScriptNum(12).GetBytes()); }
-void Script::op_13() { stack.push_back(ScriptNum(13).GetBytes()); }
-void Script::op_14() { stack.push_back(ScriptNum(14).GetBytes()); }
-void Script::op_15() { stack.push_back(ScriptNum(15).GetBytes()); }
-void Script::op_16() { stack.push_back(ScriptNum(16).GetBytes()); }
-
-void Script::op_pushadata1() { return; } // dealt with in Interpreter
-void Script::op_pushadata2() { return; } // dealt with in Interpreter
-void Script::op_pushadata4() { return; } // dealt with in Interpreter
-
-void Script::op_1negate() { stack.push_back(ScriptNum(-1).GetBytes()); }
+ScriptError Script::op_false() { return op_0(); }
+ScriptError Script::op_true()  { return op_1(); }
+
+ScriptError Script::op_0()  { PushNum(ScriptNum::Constant(0));  return SCRIPT_ERR_OK; }
+ScriptError Script::op_1()  { PushNum(ScriptNum::Constant(1));  return SCRIPT_ERR_OK; }
+ScriptError Script::op_2()  { PushNum(ScriptNum::Constant(2));  return SCRIPT_ERR_OK; }
+ScriptError Script::op_3()  { PushNum(ScriptNum::Constant(3));  return SCRIPT_ERR_OK; }
+ScriptError Script::op_4()  { PushNum(ScriptNum::Constant(4));  return SCRIPT_ERR_OK; }
+ScriptError Script::op_5()  { PushNum(ScriptNum::Constant(5));  return SCRIPT_ERR_OK; }
+ScriptError Script::op_6()  { PushNum(ScriptNum::Constant(6));  return SCRIPT_ERR_OK; }
+ScriptError Script::op_7()  { PushNum(ScriptNum::Constant(7));  return SCRIPT_ERR_OK; }
+ScriptError Script::op_8()  { PushNum(ScriptNum::Constant(8));  return SCRIPT_ERR_OK; }
+ScriptError Script::op_9()  { PushNum(ScriptNum::Constant(9));  return SCRIPT_ERR_OK; }
+ScriptError Script::op_10() { PushNum(ScriptNum::Constant(10)); return SCRIPT_ERR_OK; }
+ScriptError Script::op_11() { PushNum(ScriptNum::Constant(11)); return SCRIPT_ERR_OK; }
+ScriptError Script::op_12() { PushNum(ScriptNum::Constant(12)); return SCRIPT_ERR_OK; }
+ScriptError Script::op_13() { PushNum(ScriptNum::Constant(13)); return SCRIPT_ERR_OK; }
+ScriptError Script::op_14() { PushNum(ScriptNum::Constant(14)); return SCRIPT_ERR_OK; }
+ScriptError Script::op_15() { PushNum(ScriptNum::Constant(15)); return SCRIPT_ERR_OK; }
+ScriptError Script::op_16() { PushNum(ScriptNum::Constant(16)); return SCRIPT_ERR_OK; }
+
+ScriptError Script::op_pushadata1() { return SCRIPT_ERR_OK; } // dealt with in Interpreter
+ScriptError Script::op_pushadata2() { return SCRIPT_ERR_OK; } // dealt with in Interpreter
+ScriptError Script::op_pushadata4() { return SCRIPT_ERR_OK; } // dealt with in Interpreter
+
+ScriptError Script::op_1negate() { PushNum(ScriptNum::Constant(-1)); return SCRIPT_ERR_OK; }
 
 //////////////////////////////////////////////////////////////////////////////
 
 
 /////////////////////////////// FLOW CONTROL /////////////////////////////////
 
-void Script::op_nop()    { return; } // does nothing
-void Script::op_if()     { return; } // dealt with in Interpreter
-void Script::op_notif()  { return; } // dealt with in Interpreter
-void Script::op_else()   { return; } // dealt with in Interpreter
-void Script::op_endif()  { return; } // dealt with in Interpreter
+ScriptError Script::op_nop()    { return SCRIPT_ERR_OK; } // does nothing
+ScriptError Script::op_if()     { return SCRIPT_ERR_OK; } // dealt with in Interpreter
+ScriptError Script::op_notif()  { return SCRIPT_ERR_OK; } // dealt with in Interpreter
+ScriptError Script::op_else()   { return SCRIPT_ERR_OK; } // dealt with in Interpreter
+ScriptError Script::op_endif()  { return SCRIPT_ERR_OK; } // dealt with in Interpreter
 
 // Marks transaction as invalid if top stack value is not true (pop stack).
-void Script::op_verify() {
-    CheckStack(1, __func__);
-    if (!CastAsBool(stack.back())) 
-        throw std::runtime_error("op_verify: invalid");
+ScriptError Script::op_verify() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    if (!CastAsBool(stack.back()))
+        return SCRIPT_ERR_VERIFY;
     stack.pop_back();
+    return SCRIPT_ERR_OK;
 }
 
-// i don't fucking know
-void Script::op_return() {}
+// Marks transaction as invalid.
+ScriptError Script::op_return() { return SCRIPT_ERR_OP_RETURN; }
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -260,140 +328,162 @@ void Script::op_return() {}
 /////////////////////////////////// STACK ////////////////////////////////////
 
 // Puts the input onto the top of the alt stack. Removes it from the main stack. 
-void Script::op_toaltstack() { 
-    CheckStack(1, __func__);
-    alt_stack.push_back(stack.back()); 
+ScriptError Script::op_toaltstack() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    alt_stack.push_back(std::move(stack.back()));
     stack.pop_back();
+    return SCRIPT_ERR_OK;
 }
 
 // Puts the input onto the top of the main stack. Removes it from the alt stack. 
-void Script::op_fromaltstack() { 
-    CheckAltStack(1, __func__);
-    stack.push_back(alt_stack.back());
+ScriptError Script::op_fromaltstack() {
+    if (!CheckAltStack(1)) return SCRIPT_ERR_INVALID_ALTSTACK_OPERATION;
+    stack.push_back(std::move(alt_stack.back()));
     alt_stack.pop_back();
+    return SCRIPT_ERR_OK;
 }
 
 // If the top stack value is not 0, duplicate it. 
-void Script::op_ifdup() {
-    CheckStack(1, __func__);
+ScriptError Script::op_ifdup() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     if (CastAsBool(stack.back()))
-        op_dup();
+        return op_dup();
+    return SCRIPT_ERR_OK;
 }
 
 // Puts the number of stack items onto the stack. 
-void Script::op_depth() {
-    CheckStack(1, __func__);
-    stack.push_back(ScriptNum(stack.size()).GetBytes());
+ScriptError Script::op_depth() {
+    PushNum(ScriptNum(stack.size()).Encode());
+    return SCRIPT_ERR_OK;
 }
 
 // Removes the top stack item. 
-void Script::op_drop() {
-    CheckStack(1, __func__);
+ScriptError Script::op_drop() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     stack.pop_back();
+    return SCRIPT_ERR_OK;
 }
 
 // Duplicates the top stack item. 
-void Script::op_dup() {
-    CheckStack(1, __func__);
+ScriptError Script::op_dup() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     stack.push_back(stack.back());
+    return SCRIPT_ERR_OK;
 }
 
 // Removes the second-to-top stack item. 
-void Script::op_nip() {
-    CheckStack(2, __func__);
+ScriptError Script::op_nip() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     stack.erase(stack.end()-2);
+    return SCRIPT_ERR_OK;
 }
 
 // Copies the second-to-top stack item to the top. 
-void Script::op_over() {
-    CheckStack(2, __func__);
+ScriptError Script::op_over() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     stack.push_back(stack.end()[-2]);
+    return SCRIPT_ERR_OK;
 }
 
 // The item n back in the stack is copied to the top.
-void Script::op_pick() {
-    CheckStack(1, __func__);
-    auto num = ScriptNum(stack.back()).GetInt();
+ScriptError Script::op_pick() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum num;
+    if (!PeekNum(1, num)) return SCRIPT_ERR_UNKNOWN_ERROR;
     stack.pop_back();
-    CheckStack(num, __func__);
-    stack.push_back(stack.end()[-num]);
+    if (num < 0 || num >= (int64_t)stack.size())
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.push_back(stack.end()[-num.GetInt()-1]);
+    return SCRIPT_ERR_OK;
 }
 
 // The item n back in the stack is moved to the top.
-void Script::op_roll() {
-    CheckStack(1, __func__);
-    auto num = ScriptNum(stack.back()).GetInt();
+ScriptError Script::op_roll() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum num;
+    if (!PeekNum(1, num)) return SCRIPT_ERR_UNKNOWN_ERROR;
     stack.pop_back();
-    CheckStack(num, __func__);
-    auto val = std::move(stack.end()[-num]);
-    stack.erase(stack.end()-num);
-    stack.push_back(val);
+    if (num < 0 || num >= (int64_t)stack.size())
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    auto val = std::move(stack.end()[-num.GetInt()-1]);
+    stack.erase(stack.end()-num.GetInt()-1);
+    stack.push_back(std::move(val));
+    return SCRIPT_ERR_OK;
 }
 
 // The 3rd item down the stack is moved to the top. 
-void Script::op_rot() {
-    CheckStack(3, __func__);
-    auto val = std::move(stack.end()[-3]);
-    stack.erase(stack.end()-3);
-    stack.push_back(val);
+ScriptError Script::op_rot() {
+    if (!CheckStack(3)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    std::swap(stack.end()[-3], stack.end()[-2]);
+    std::swap(stack.end()[-2], stack.end()[-1]);
+    return SCRIPT_ERR_OK;
 }
 
 // The top two items on the stack are swapped. 
-void Script::op_swap() {
-    CheckStack(2, __func__);
+ScriptError Script::op_swap() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     std::swap(stack.end()[-1], stack.end()[-2]);
+    return SCRIPT_ERR_OK;
 }
 
 // The item at the top of the stack is copied and inserted before the second-to-top item. 
-void Script::op_tuck() {
-    CheckStack(2, __func__);
-    stack.insert(stack.end()-2, stack.end()[-1]);
+ScriptError Script::op_tuck() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    auto val = stack.back();
+    stack.insert(stack.end()-2, std::move(val));
+    return SCRIPT_ERR_OK;
 }
 
 // Removes the top two stack items. 
-void Script::op_2drop() {
-    CheckStack(2, __func__);
+ScriptError Script::op_2drop() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     stack.pop_back();
     stack.pop_back();
+    return SCRIPT_ERR_OK;
 }
 
 // Duplicates the top two stack items.
-void Script::op_2dup() {
-    CheckStack(2, __func__);
+ScriptError Script::op_2dup() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     stack.push_back(stack.end()[-2]);
     stack.push_back(stack.end()[-2]);
+    return SCRIPT_ERR_OK;
 }
 
 // Duplicates the top three stack items.
-void Script::op_3dup() {
-    CheckStack(3, __func__);
+ScriptError Script::op_3dup() {
+    if (!CheckStack(3)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     stack.push_back(stack.end()[-3]);
     stack.push_back(stack.end()[-3]);
     stack.push_back(stack.end()[-3]);
+    return SCRIPT_ERR_OK;
 }
 
 // Copies the pair of items two spaces back in the stack to the front. 
-void Script::op_2over() {
-    CheckStack(4, __func__);
+ScriptError Script::op_2over() {
+    if (!CheckStack(4)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     stack.push_back(stack.end()[-4]);
     stack.push_back(stack.end()[-4]);
+    return SCRIPT_ERR_OK;
 }
 
 // The fifth and sixth items back are moved to the top of the stack. 
-void Script::op_2rot() {
-    CheckStack(6, __func__);
+ScriptError Script::op_2rot() {
+    if (!CheckStack(6)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     auto val1 = std::move(stack.end()[-6]);
     auto val2 = std::move(stack.end()[-5]);
     stack.erase(stack.end()-6, stack.end()-4);
-    stack.push_back(val1);
-    stack.push_back(val2);
+    stack.push_back(std::move(val1));
+    stack.push_back(std::move(val2));
+    return SCRIPT_ERR_OK;
 }
 
 // Swaps the top two pairs of items. 
-void Script::op_2swap() {
-    CheckStack(4, __func__);
+ScriptError Script::op_2swap() {
+    if (!CheckStack(4)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
     std::swap(stack.end()[-4], stack.end()[-2]);
     std::swap(stack.end()[-3], stack.end()[-1]);
+    return SCRIPT_ERR_OK;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -401,15 +491,16 @@ void Script::op_2swap() {
 
 /////////////////////////////////// SPLICE ///////////////////////////////////
 
-void Script::op_cat()    { DisabledOperation(__func__); }
-void Script::op_substr() { DisabledOperation(__func__); }
-void Script::op_left()   { DisabledOperation(__func__); } 
-void Script::op_right()  { DisabledOperation(__func__); } 
+ScriptError Script::op_cat()    { return SCRIPT_ERR_DISABLED_OPCODE; }
+ScriptError Script::op_substr() { return SCRIPT_ERR_DISABLED_OPCODE; }
+ScriptError Script::op_left()   { return SCRIPT_ERR_DISABLED_OPCODE; }
+ScriptError Script::op_right()  { return SCRIPT_ERR_DISABLED_OPCODE; }
 
 // Pushes the string length of the top element of the stack.
-void Script::op_size() {
-    CheckStack(1, __func__);
-    stack.push_back(ScriptNum(stack.back().size()).GetBytes());
+ScriptError Script::op_size() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    PushNum(ScriptNum(stack.back().size()).Encode());
+    return SCRIPT_ERR_OK;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -417,25 +508,24 @@ void Script::op_size() {
 
 //////////////////////////////// BITWISE LOGIC ///////////////////////////////
 
-void Script::op_invert() { DisabledOperation(__func__); }
-void Script::op_and()    { DisabledOperation(__func__); }
-void Script::op_or()     { DisabledOperation(__func__); }
-void Script::op_xor()    { DisabledOperation(__func__); }
+ScriptError Script::op_invert() { return SCRIPT_ERR_DISABLED_OPCODE; }
+ScriptError Script::op_and()    { return SCRIPT_ERR_DISABLED_OPCODE; }
+ScriptError Script::op_or()     { return SCRIPT_ERR_DISABLED_OPCODE; }
+ScriptError Script::op_xor()    { return SCRIPT_ERR_DISABLED_OPCODE; }
 
 // Returns 1 if the inputs are exactly equal, 0 otherwise. 
-void Script::op_equal() {
-    CheckStack(2, __func__);
-    auto rhs = stack.back(); stack.pop_back();
-    auto lhs = stack.back(); stack.pop_back();
-    if (lhs == rhs)
-         stack.push_back(ScriptNum(1).GetBytes());
-    else stack.push_back(ScriptNum(0).GetBytes());
+ScriptError Script::op_equal() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    bool equal = stack.end()[-2] == stack.end()[-1];
+    ReplaceNum(2, ScriptNum(equal));
+    return SCRIPT_ERR_OK;
 }
 
 // Same as OP_EQUAL, but runs OP_VERIFY afterward.
-void Script::op_equalverify() {
-    op_equal();
-    op_verify();
+ScriptError Script::op_equalverify() {
+    if (auto error = op_equal())
+        return error;
+    return op_verify() ? SCRIPT_ERR_EQUALVERIFY : SCRIPT_ERR_OK;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -444,180 +534,190 @@ void Script::op_equalverify() {
 ////////////////////////////////// ARITHMETIC ////////////////////////////////
 
 // 1 is added to the input.
-void Script::op_1add() {
-    CheckStack(1, __func__);
-    ScriptNum num(stack.back()); stack.pop_back();
-    stack.push_back((num+1).GetBytes());
+ScriptError Script::op_1add() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum num;
+    if (!PeekNum(1, num)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(1, num+1);
+    return SCRIPT_ERR_OK;
 }
 
 // 1 is subtracted from the input. 
-void Script::op_1sub() {
-    CheckStack(1, __func__);
-    ScriptNum num(stack.back()); stack.pop_back();
-    stack.push_back((num-1).GetBytes());
+ScriptError Script::op_1sub() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum num;
+    if (!PeekNum(1, num)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(1, num-1);
+    return SCRIPT_ERR_OK;
 }
 
-void Script::op_2mul() { DisabledOperation(__func__); }
-void Script::op_2div() { DisabledOperation(__func__); }
+ScriptError Script::op_2mul() { return SCRIPT_ERR_DISABLED_OPCODE; }
+ScriptError Script::op_2div() { return SCRIPT_ERR_DISABLED_OPCODE; }
 
 // The sign of the input is flipped. 
-void Script::op_negate() {
-    CheckStack(1, __func__);
-    ScriptNum num(stack.back()); stack.pop_back();
-    stack.push_back((-num).GetBytes());
+ScriptError Script::op_negate() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum num;
+    if (!PeekNum(1, num)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(1, -num);
+    return SCRIPT_ERR_OK;
 }
 
 // The input is made positive. 
-void Script::op_abs() {
-    CheckStack(1, __func__);
-    ScriptNum num(stack.back()); stack.pop_back();
-    stack.push_back((num > 0 ? num : -num).GetBytes());
+ScriptError Script::op_abs() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum num;
+    if (!PeekNum(1, num)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(1, num < 0 ? -num : num);
+    return SCRIPT_ERR_OK;
 }
 
 // If the input is 0 or 1, it is flipped. Otherwise the output will be 0.
-void Script::op_not() {
-    CheckStack(1, __func__);
-    ScriptNum num(stack.back()); stack.pop_back();
-    if (num == 0) stack.push_back(ScriptNum(1).GetBytes());
-    else if (num == 1) stack.push_back(ScriptNum(0).GetBytes());
-    else stack.push_back(ScriptNum(0).GetBytes());
+ScriptError Script::op_not() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum num;
+    if (!PeekNum(1, num)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(1, ScriptNum(num == 0));
+    return SCRIPT_ERR_OK;
 }
 
 // Returns 0 if the input is 0. 1 otherwise. 
-void Script::op_0notequal() {
-    CheckStack(1, __func__);
-    ScriptNum num(stack.back());
-    if (num != 0) { 
-        stack.pop_back();
-        stack.push_back(ScriptNum(1).GetBytes());
-    }
+ScriptError Script::op_0notequal() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum num;
+    if (!PeekNum(1, num)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(1, ScriptNum(num != 0));
+    return SCRIPT_ERR_OK;
 }
 
 // lhs is added to rhs.
-void Script::op_add() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    stack.push_back((lhs+rhs).GetBytes());
+ScriptError Script::op_add() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, lhs+rhs);
+    return SCRIPT_ERR_OK;
 }
 
 // rhs is subtracted from lhs. 
-void Script::op_sub() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    stack.push_back((lhs-rhs).GetBytes());
+ScriptError Script::op_sub() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, lhs-rhs);
+    return SCRIPT_ERR_OK;
 }
 
-void Script::op_mul()    { DisabledOperation(__func__); }
-void Script::op_div()    { DisabledOperation(__func__); }
-void Script::op_mod()    { DisabledOperation(__func__); }
-void Script::op_lshift() { DisabledOperation(__func__); } 
-void Script::op_rshift() { DisabledOperation(__func__); } 
+ScriptError Script::op_mul()    { return SCRIPT_ERR_DISABLED_OPCODE; }
+ScriptError Script::op_div()    { return SCRIPT_ERR_DISABLED_OPCODE; }
+ScriptError Script::op_mod()    { return SCRIPT_ERR_DISABLED_OPCODE; }
+ScriptError Script::op_lshift() { return SCRIPT_ERR_DISABLED_OPCODE; }
+ScriptError Script::op_rshift() { return SCRIPT_ERR_DISABLED_OPCODE; }
 
 // If both lhs and rhs are not 0, the output is 1. Otherwise 0.
-void Script::op_booland() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    if (lhs != 0 && rhs != 0) stack.push_back(ScriptNum(1).GetBytes());
-    else stack.push_back(ScriptNum(0).GetBytes());
+ScriptError Script::op_booland() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, ScriptNum(lhs != 0 && rhs != 0));
+    return SCRIPT_ERR_OK;
 }
 
 // If lhs or rhs is not 0, the output is 1. Otherwise 0. 
-void Script::op_boolor() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    if (lhs != 0 || rhs != 0) stack.push_back(ScriptNum(1).GetBytes());
-    else stack.push_back(ScriptNum(0).GetBytes());
+ScriptError Script::op_boolor() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, ScriptNum(lhs != 0 || rhs != 0));
+    return SCRIPT_ERR_OK;
 }
 
 // Returns 1 if the numbers are equal, 0 otherwise.
-void Script::op_numequal() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    if (lhs == rhs) stack.push_back(ScriptNum(1).GetBytes());
-    else stack.push_back(ScriptNum(0).GetBytes());
+ScriptError Script::op_numequal() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, ScriptNum(lhs == rhs));
+    return SCRIPT_ERR_OK;
 }
 
 // Same as OP_NUMEQUAL, but runs OP_VERIFY afterward.
-void Script::op_numequalverify() {
-    op_numequal();
-    op_verify();
+ScriptError Script::op_numequalverify() {
+    if (auto error = op_numequal())
+        return error;
+    return op_verify() ? SCRIPT_ERR_NUMEQUALVERIFY : SCRIPT_ERR_OK;
 }
 
 // Returns 1 if the numbers are not equal, 0 otherwise.
-void Script::op_numnotequal() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    if (lhs != rhs) stack.push_back(ScriptNum(1).GetBytes());
-    else stack.push_back(ScriptNum(0).GetBytes());
+ScriptError Script::op_numnotequal() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, ScriptNum(lhs != rhs));
+    return SCRIPT_ERR_OK;
 }
 
 // Returns 1 if lhs is less than rhs, 0 otherwise. 
-void Script::op_lessthan() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    if (lhs < rhs) stack.push_back(ScriptNum(1).GetBytes());
-    else stack.push_back(ScriptNum(0).GetBytes());
+ScriptError Script::op_lessthan() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, ScriptNum(lhs < rhs));
+    return SCRIPT_ERR_OK;
 }
 
 // Returns 1 if lhs is greater than rhs, 0 otherwise.
-void Script::op_greaterthan() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    if (lhs > rhs) stack.push_back(ScriptNum(1).GetBytes());
-    else stack.push_back(ScriptNum(0).GetBytes());
+ScriptError Script::op_greaterthan() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, ScriptNum(lhs > rhs));
+    return SCRIPT_ERR_OK;
 }
 
 // Returns 1 if lhs is less than or equal to rhs, 0 otherwise.
-void Script::op_lessthanorequal() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    if (lhs <= rhs) stack.push_back(ScriptNum(1).GetBytes());
-    else stack.push_back(ScriptNum(0).GetBytes());
+ScriptError Script::op_lessthanorequal() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, ScriptNum(lhs <= rhs));
+    return SCRIPT_ERR_OK;
 }
 
 // Returns 1 if lhs is greater than or equal to rhs, 0 otherwise. 
-void Script::op_greaterthanorequal() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    if (lhs >= rhs) stack.push_back(ScriptNum(1).GetBytes());
-    else stack.push_back(ScriptNum(0).GetBytes());
+ScriptError Script::op_greaterthanorequal() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, ScriptNum(lhs >= rhs));
+    return SCRIPT_ERR_OK;
 }
 
 // Returns the smaller of lhs and rhs. 
-void Script::op_min() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    stack.push_back(lhs < rhs ? lhs.GetBytes() : rhs.GetBytes());
+ScriptError Script::op_min() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, lhs < rhs ? lhs : rhs);
+    return SCRIPT_ERR_OK;
 }
 
 // Returns the larger of lhs and rhs.
-void Script::op_max() {
-    CheckStack(2, __func__);
-    ScriptNum rhs(stack.back()); stack.pop_back();
-    ScriptNum lhs(stack.back()); stack.pop_back();
-    stack.push_back(lhs > rhs ? lhs.GetBytes() : rhs.GetBytes());
+ScriptError Script::op_max() {
+    if (!CheckStack(2)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum lhs, rhs;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(2, lhs > rhs ? lhs : rhs);
+    return SCRIPT_ERR_OK;
 }
 
 // Returns 1 if x is within the specified range (left-inclusive), 0 otherwise. 
-void Script::op_within() {
-    CheckStack(3, __func__);
-    ScriptNum max(stack.back()); stack.pop_back();
-    ScriptNum min(stack.back()); stack.pop_back();
-    ScriptNum val(stack.back()); stack.pop_back();
-    if (val >= min && val < max) 
-        stack.push_back(ScriptNum(1).GetBytes());
-    else stack.push_back(ScriptNum(0).GetBytes());
+ScriptError Script::op_within() {
+    if (!CheckStack(3)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    ScriptNum val, min, max;
+    if (!PeekNum(3, val) || !PeekNum(2, min) || !PeekNum(1, max)) return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(3, ScriptNum(val >= min && val < max));
+    return SCRIPT_ERR_OK;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -626,49 +726,45 @@ void Script::op_within() {
 /////////////////////////////////// CRYPTO ///////////////////////////////////
 
 // The input is hashed using RIPEMD-160. 
-void Script::op_ripemd160() {
-    CheckStack(1, __func__);
-    auto hash = ripemd160(stack.back());
-    stack.pop_back();
-    stack.push_back(hash);
+ScriptError Script::op_ripemd160() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.back() = ripemd160(stack.back());
+    return SCRIPT_ERR_OK;
 }
 
 // The input is hashed using SHA-1. 
-void Script::op_sha1() {
-    CheckStack(1, __func__);
-    auto hash = sha1(stack.back());
-    stack.pop_back();
-    stack.push_back(hash);
+ScriptError Script::op_sha1() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.back() = sha1(stack.back());
+    return SCRIPT_ERR_OK;
 }
 
 // The input is hashed using SHA-256. 
-void Script::op_sha256() {
-    CheckStack(1, __func__);
-    auto hash = sha256(stack.back());
-    stack.pop_back();
-    stack.push_back(hash);
+ScriptError Script::op_sha256() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.back() = sha256(stack.back());
+    return SCRIPT_ERR_OK;
 }
 
 // The input is hashed twice: first with SHA-256 and then with RIPEMD-160. 
-void Script::op_hash160() {
-    CheckStack(1, __func__);
-    auto hash = hash160(stack.back());
-    stack.pop_back();
-    stack.push_back(hash);
+ScriptError Script::op_hash160() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.back() = hash160(stack.back());
+    return SCRIPT_ERR_OK;
 }
 
 // The input is hashed two times with SHA-256. 
-void Script::op_hash256() {
-    CheckStack(1, __func__);
-    auto hash = hash256(stack.back());
-    stack.pop_back();
-    stack.push_back(hash);
+ScriptError Script::op_hash256() {
+    if (!CheckStack(1)) return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.back() = hash256(stack.back());
+    return SCRIPT_ERR_OK;
 }
 
+
 /*  All of the signature checking words will only match signatures to 
     the data after the most recently-executed OP_CODESEPARATOR. */
-void Script::op_codeseparator() {
-
+ScriptError Script::op_codeseparator() {
+    return SCRIPT_ERR_OK;
 }
 
 /* The entire transaction's outputs, inputs, and script 
@@ -676,13 +772,13 @@ void Script::op_codeseparator() {
    The signature used by OP_CHECKSIG must be a valid signature for this hash
    and public key. 
    If it is, 1 is returned, 0 otherwise. */
-void Script::op_checksig() {
-
+ScriptError Script::op_checksig() {
+    return SCRIPT_ERR_OK;
 }
 
 // Same as OP_CHECKSIG, but OP_VERIFY is executed afterward. 
-void Script::op_checksigverify() {
-
+ScriptError Script::op_checksigverify() {
+    return SCRIPT_ERR_OK;
 }
 
 /* Compares the first signature against each public key until it finds 
@@ -698,8 +794,8 @@ void Script::op_checksigverify() {
    or redeemScript. 
    If all signatures are valid, 1 is returned, 0 otherwise. 
    Due to a bug, one extra unused value is removed from the stack. */
-void Script::op_checkmultisigverify() {
-
+ScriptError Script::op_checkmultisigverify() {
+    return SCRIPT_ERR_OK;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -718,8 +814,8 @@ void Script::op_checkmultisigverify() {
    4. the input's nSequence field is equal to 0xffffffff.
    The precise semantics are described in BIP-0065:
    https://github.com/bitcoin/bips/blob/master/bip-0065.mediawiki. */
-void Script::op_checklocktimeverify() {
-
+ScriptError Script::op_checklocktimeverify() {
+    return SCRIPT_ERR_OK;
 }
 
 /* Marks transaction as invalid if the relative lock time of the input 
@@ -727,21 +823,21 @@ void Script::op_checklocktimeverify() {
    the value of the top stack item. 
    The precise semantics are described in BIP-0112:
    https://github.com/bitcoin/bips/blob/master/bip-0112.mediawiki */
-void Script::op_checksequenceverify() {
-
+ScriptError Script::op_checksequenceverify() {
+    return SCRIPT_ERR_OK;
 }
 
-void Script::op_nop2() { op_checklocktimeverify(); }
-void Script::op_nop3() { op_checksequenceverify(); }
+ScriptError Script::op_nop2() { return op_checklocktimeverify(); }
+ScriptError Script::op_nop3() { return op_checksequenceverify(); }
 
 //////////////////////////////////////////////////////////////////////////////
 
 
 //////////////////////////////// PSEUDO-WORDS ////////////////////////////////
 
-void Script::op_pubkey()        { InvalidOperation(__func__); }
-void Script::op_pubkeyhash()    { InvalidOperation(__func__); }
-void Script::op_invalidopcode() { InvalidOperation(__func__); }
+ScriptError Script::op_pubkey()        { return SCRIPT_ERR_BAD_OPCODE; }
+ScriptError Script::op_pubkeyhash()    { return SCRIPT_ERR_BAD_OPCODE; }
+ScriptError Script::op_invalidopcode() { return SCRIPT_ERR_BAD_OPCODE; }
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -749,47 +845,43 @@ void Script::op_invalidopcode() { InvalidOperation(__func__); }
 /////////////////////////////// RESERVED WORDS ///////////////////////////////
 
 // Transaction is invalid unless occuring in an unexecuted OP_IF branch 
-void Script::op_reserved() {
-    if (!(run_this.size() > 1 && !run_this.top()))
-        InvalidOperation(__func__);
+ScriptError Script::op_reserved() {
+    return SCRIPT_ERR_BAD_OPCODE;
 }
     
 // Transaction is invalid unless occuring in an unexecuted OP_IF branch 
-void Script::op_ver() {
-    if (!(run_this.size() > 1 && !run_this.top()))
-        InvalidOperation(__func__);
+ScriptError Script::op_ver() {
+    return SCRIPT_ERR_BAD_OPCODE;
 } 
 
 // Transaction is invalid even when occuring in an unexecuted OP_IF branch
-void Script::op_verif() {
-    InvalidOperation(__func__);
+ScriptError Script::op_verif() {
+    return SCRIPT_ERR_BAD_OPCODE;
 } 
 
 // Transaction is invalid even when occuring in an unexecuted OP_IF branch 
-void Script::op_vernotif() {
-    InvalidOperation(__func__);
+ScriptError Script::op_vernotif() {
+    return SCRIPT_ERR_BAD_OPCODE;
 }
 
 // Transaction is invalid unless occuring in an unexecuted OP_IF branch
-void Script::op_reserved1() {
-    if (!(run_this.size() > 1 && !run_this.top()))
-        InvalidOperation(__func__);
+ScriptError Script::op_reserved1() {
+    return SCRIPT_ERR_BAD_OPCODE;
 }
 
 // Transaction is invalid unless occuring in an unexecuted OP_IF branch 
-void Script::op_reserved2() {
-    if (!(run_this.size() > 1 && !run_this.top()))
-        InvalidOperation(__func__);
+ScriptError Script::op_reserved2() {
+    return SCRIPT_ERR_BAD_OPCODE;
 }
 
-void Script::op_nop1()  { return; } // does nothing 
-void Script::op_nop4()  { return; } // does nothing
-void Script::op_nop5()  { return; } // does nothing
-void Script::op_nop6()  { return; } // does nothing
-void Script::op_nop7()  { return; } // does nothing
-void Script::op_nop8()  { return; } // does nothing
-void Script::op_nop9()  { return; } // does nothing
-void Script::op_nop10() { return; } // does nothing
+ScriptError Script::op_nop1()  { return SCRIPT_ERR_OK; } // does nothing 
+ScriptError Script::op_nop4()  { return SCRIPT_ERR_OK; } // does nothing
+ScriptError Script::op_nop5()  { return SCRIPT_ERR_OK; } // does nothing
+ScriptError Script::op_nop6()  { return SCRIPT_ERR_OK; } // does nothing
+ScriptError Script::op_nop7()  { return SCRIPT_ERR_OK; } // does nothing
+ScriptError Script::op_nop8()  { return SCRIPT_ERR_OK; } // does nothing
+ScriptError Script::op_nop9()  { return SCRIPT_ERR_OK; } // does nothing
+ScriptError Script::op_nop10() { return SCRIPT_ERR_OK; } // does nothing
 
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
@@ -893,9 +985,9 @@ OperationHashMap {
     {OP_NUMEQUALVERIFY,      {"OP_NUMEQUALVERIFY",      &Script::op_numequalverify}},
     {OP_NUMNOTEQUAL,         {"OP_NUMNOTEQUAL",         &Script::op_numnotequal}},
     {OP_LESSTHAN,            {"OP_LESSTHAN",            &Script::op_lessthan}},
-    {OP_GREATERTHAN,         {"OP_GREATHERTHAN",        &Script::op_greaterthan}},
+    {OP_GREATERTHAN,         {"OP_GREATERTHAN",         &Script::op_greaterthan}},
     {OP_LESSTHANOREQUAL,     {"OP_LESSTHANOREQUAL",     &Script::op_lessthanorequal}},
-    {OP_GREATERTHANOREQUAL,  {"OP_GREATHERTHANOREQUAL", &Script::op_greaterthanorequal}},
+    {OP_GREATERTHANOREQUAL,  {"OP_GREATERTHANOREQUAL",  &Script::op_greaterthanorequal}},
     {OP_MIN,                 {"OP_MIN",                 &Script::op_min}},
     {OP_MAX,                 {"OP_MAX",                 &Script::op_max}},
     {OP_WITHIN,              {"OP_WITHIN",              &Script::op_within}},
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "ScriptNum.hpp"
+#include "ScriptAnalysis.hpp"
+#include "ScriptError.hpp"
 #include "OpEnum.hpp"
 #include "utils.hpp"
+#include "serialize.hpp"
 
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include <stack>
 #include <iomanip>
 #include <unordered_map>
@@ -18,26 +22,107 @@ static const int32_t  MAX_PUBKEYS_PER_MULTISIG = 20;
 static const uint32_t LOCKTIME_THRESHOLD       = 500000000;
 static const uint32_t LOCKTIME_MAX             = 0xFFFFFFFFU;
 
+// Which interpreter Script::Run uses. Threaded needs GCC/Clang computed
+// goto and falls back to Reference elsewhere.
+enum class ScriptEngine {
+    Reference,  // Interpreter(): decode and dispatch one OP at a time.
+    Threaded    // ThreadedInterpreter(): pre-decoded, direct-threaded code.
+};
+
+// Script verification flags, same bits as Bitcoin Core's SCRIPT_VERIFY_*.
+// Only P2SH, SIGPUSHONLY and CLEANSTACK change what Script::Verify does,
+// the others are accepted so callers can pass Core's flag sets unchanged.
+enum ScriptVerifyFlags : uint32_t {
+    SCRIPT_VERIFY_NONE                                  = 0,
+    SCRIPT_VERIFY_P2SH                                  = (1U << 0),
+    SCRIPT_VERIFY_STRICTENC                             = (1U << 1),
+    SCRIPT_VERIFY_DERSIG                                = (1U << 2),
+    SCRIPT_VERIFY_LOW_S                                 = (1U << 3),
+    SCRIPT_VERIFY_NULLDUMMY                             = (1U << 4),
+    SCRIPT_VERIFY_SIGPUSHONLY                           = (1U << 5),
+    SCRIPT_VERIFY_MINIMALDATA                           = (1U << 6),
+    SCRIPT_VERIFY_DISCOURAGE_UPGRADABLE_NOPS            = (1U << 7),
+    SCRIPT_VERIFY_CLEANSTACK                            = (1U << 8),
+    SCRIPT_VERIFY_CHECKLOCKTIMEVERIFY                   = (1U << 9),
+    SCRIPT_VERIFY_CHECKSEQUENCEVERIFY                   = (1U << 10),
+    SCRIPT_VERIFY_WITNESS                               = (1U << 11),
+    SCRIPT_VERIFY_DISCOURAGE_UPGRADABLE_WITNESS_PROGRAM = (1U << 12),
+    SCRIPT_VERIFY_MINIMALIF                             = (1U << 13),
+    SCRIPT_VERIFY_NULLFAIL                              = (1U << 14),
+    SCRIPT_VERIFY_WITNESS_PUBKEYTYPE                    = (1U << 15),
+    SCRIPT_VERIFY_CONST_SCRIPTCODE                      = (1U << 16),
+    SCRIPT_VERIFY_TAPROOT                               = (1U << 17),
+};
+
 class Script;
-using OperationPointer = void (Script::*)(void);
+using OperationPointer = ScriptError (Script::*)(void);
 using OperationPair    = std::pair<std::string, OperationPointer>;
 using OperationHashMap = std::unordered_map<OpEnum, OperationPair>;
 
 class Script {
 public:
     Script() {}
-    explicit Script(const std::string& hex): exec(hex2bytes(hex)) {}
-    explicit Script(const std::vector<uint8_t>& bytes): exec(bytes) {}
+    explicit Script(const std::string& hex): Script(std::span<const uint8_t>(hex2bytes(hex))) {}
+    explicit Script(std::pmr::vector<uint8_t> bytes): exec(std::move(bytes)) {}
+    // The bytes are allocated from `resource` (e.g. a per-block arena, see
+    // Tx), copies of the script go back to the default one.
+    explicit Script(std::pmr::memory_resource* resource): exec(resource) {}
+    explicit Script(std::span<const uint8_t> bytes,
+                    std::pmr::memory_resource* resource = std::pmr::get_default_resource()):
+        exec(bytes.begin(), bytes.end(), resource) {}
     
-    // Script Execution
-    std::vector<uint8_t> Run();
+    // Script Execution, returns the top stack element or the error that stopped it.
+    ScriptResult<std::vector<uint8_t>> Run(ScriptEngine engine = ScriptEngine::Reference);
+
+    // Run script_sig then script_pubkey on the same stack, and the redeem
+    // script as well for P2SH if enabled (Bitcoin Core's VerifyScript). The
+    // scripts are only read: the stacks and the threaded code live in a
+    // local interpreter, so transactions' scripts can be verified in place.
+    static ScriptError Verify(const Script& script_sig, const Script& script_pubkey,
+                              uint32_t flags = SCRIPT_VERIFY_NONE,
+                              ScriptEngine engine = ScriptEngine::Reference);
+
+    // Print each OP and the final stack while running (Reference engine only).
+    void SetTrace(bool enable) { trace = enable; }
+
+    // Script Analysis (single pass, no execution)
+    ScriptAnalysis        Analyze() const { return Analyze(exec); }
+    static ScriptAnalysis Analyze(std::span<const uint8_t> script);
+
+    // Decode the OP at `pc` and advance past it and its data (if any).
+    // Returns false if the data runs past `end`.
+    static bool GetOp(const uint8_t*& pc, const uint8_t* end, uint8_t& opcode,
+                      const uint8_t*& data, uint32_t& data_size);
+
+    // Name of an OP as Bitcoin Core prints it ("OP_DUP", "OP_CHECKSIG", ...).
+    static const char* GetOpName(uint8_t opcode);
+
+    // Parse the asm notation of Bitcoin Core's test vectors: decimal numbers,
+    // raw 0x-prefixed hex, 'quoted' data pushes and OP names with or without
+    // the OP_ prefix. Throws on anything else.
+    static Script FromAsm(const std::string& asm_script);
+
+    bool IsPushOnly()        const;
+    bool IsPayToScriptHash() const;
 
     // Script Insertion / Serialization
-    Script& operator<<(const OpEnum& op);
-    Script& operator<<(const int32_t& num);
-    Script& operator<<(const std::vector<uint8_t>& data);
+    Script& operator<<(const OpEnum& op) &;
+    Script& operator<<(const int32_t& num) &;
+    Script& operator<<(std::span<const uint8_t> data) &;
+    // Same on a temporary (Script() << OP_DUP << ...), which then moves out.
+    Script&& operator<<(const OpEnum& op) &&               { return std::move(*this << op); }
+    Script&& operator<<(const int32_t& num) &&             { return std::move(*this << num); }
+    Script&& operator<<(std::span<const uint8_t> data) &&  { return std::move(*this << data); }
+
+    const std::pmr::vector<uint8_t>& GetBytes() const { return exec; };
+    std::span<const uint8_t> GetSpan()  const { return exec; }
+    size_t                   GetSize()  const { return exec.size(); }
 
-    std::vector<uint8_t> GetBytes() const { return exec; };
+    // CompactSize length, then the bytes (see serialize.hpp).
+    template <typename Stream>
+    void Serialize(Stream& s) const { ::Serialize(s, exec); }
+    template <typename Stream>
+    void Unserialize(Stream& s) { ::Unserialize(s, exec); threaded.clear(); }
 
     friend auto& operator<<(std::ostream& out, const Script& script) {
         for (auto& b: script.exec)
@@ -50,169 +135,197 @@ private:
     std::vector<std::vector<uint8_t>> stack;
     std::vector<std::vector<uint8_t>> alt_stack;
     // The script serialized bytes.
-    std::vector<uint8_t> exec;
-    // Stack of boolean used for nested conditional blocks.
-    std::stack<bool> run_this; 
+    std::pmr::vector<uint8_t> exec;
+    // Stack of boolean used for nested conditional blocks,
+    // and how many of them are false (nothing runs unless 0).
+    std::vector<bool> run_this;
+    size_t            run_this_false = 0;
     // Hashmap of OpEnum -> pair(str(OP), function_ptr(OP));
     static OperationHashMap ScriptInterface;
+    bool trace = false;
 
-    void Interpreter(const std::vector<uint8_t>& exec);
-    bool CastAsBool(std::vector<uint8_t> bytes)      const;
-    void CheckStack(size_t n, const char* _func_)    const;
-    void CheckAltStack(size_t n, const char* _func_) const;
-    void DisabledOperation(const char* _func_)       const;
-    void InvalidOperation(const char* _func_)        const;
+    // One pre-decoded OP of direct-threaded code (see ScriptThreaded.cpp).
+    // Offsets rather than pointers into the script, so copies stay valid.
+    struct ThreadedOp {
+        const void*      label;  // handler address
+        OperationPointer op;     // out-of-line handler for the generic case
+        uint32_t         offset; // pushed data offset in `exec`
+        uint32_t         size;   // pushed data size / constant value
+        uint32_t         jump;   // conditionals: index following the matching OP_ELSE/OP_ENDIF
+        uint8_t          opcode; // tells apart OPs sharing a handler
+    };
+    // Run()'s, decoded lazily by ThreadedInterpreter(), cleared whenever
+    // `exec` changes.
+    std::vector<ThreadedOp> threaded;
+
+    // Run `script` on top of `io_stack` (swapped in and back out), without
+    // Run()'s final checks. Lets Verify() chain scripts on one stack, `this`
+    // being only the interpreter's state.
+    ScriptError Eval(std::span<const uint8_t> script, std::vector<std::vector<uint8_t>>& io_stack,
+                     ScriptEngine engine);
+    // Analyze then interpret `script` on the current stack, its threaded
+    // code decoded into `code` if empty.
+    ScriptError Execute(std::span<const uint8_t> script, ScriptEngine engine,
+                        std::vector<ThreadedOp>& code);
+    ScriptError Interpreter(std::span<const uint8_t> script);
+    ScriptError ThreadedInterpreter(std::span<const uint8_t> script, std::vector<ThreadedOp>& code);
+    bool CastAsBool(const std::vector<uint8_t>& bytes) const;
+    bool CheckStack(size_t n)                          const { return stack.size() >= n; }
+    bool CheckAltStack(size_t n)                       const { return alt_stack.size() >= n; }
+    bool PeekNum(size_t depth, ScriptNum& num) const;
+    void PushNum(const ScriptNum::Bytes& bytes);
+    void ReplaceNum(size_t n, const ScriptNum& num);
 
     ////////////////// SCRIPT OPERATIONS //////////////////
 
     // Constants
 
-    void op_0();
-    void op_1();
-    void op_2();
-    void op_3();
-    void op_4();
-    void op_5();
-    void op_6();
-    void op_7();
-    void op_8();
-    void op_9();
-    void op_10();
-    void op_11();
-    void op_12();
-    void op_13();
-    void op_14();
-    void op_15();
-    void op_16();
-
-    void op_false();
-    void op_true();
-
-    void op_pushadata1();
-    void op_pushadata2();
-    void op_pushadata4();
-    void op_1negate();
+    ScriptError op_0();
+    ScriptError op_1();
+    ScriptError op_2();
+    ScriptError op_3();
+    ScriptError op_4();
+    ScriptError op_5();
+    ScriptError op_6();
+    ScriptError op_7();
+    ScriptError op_8();
+    ScriptError op_9();
+    ScriptError op_10();
+    ScriptError op_11();
+    ScriptError op_12();
+    ScriptError op_13();
+    ScriptError op_14();
+    ScriptError op_15();
+    ScriptError op_16();
+
+    ScriptError op_false();
+    ScriptError op_true();
+
+    ScriptError op_pushadata1();
+    ScriptError op_pushadata2();
+    ScriptError op_pushadata4();
+    ScriptError op_1negate();
 
     // Flow Control
 
-    void op_nop();
-    void op_if();
-    void op_notif();
-    void op_else();
-    void op_endif();
-    void op_verify();
-    void op_return(); //
+    ScriptError op_nop();
+    ScriptError op_if();
+    ScriptError op_notif();
+    ScriptError op_else();
+    ScriptError op_endif();
+    ScriptError op_verify();
+    ScriptError op_return(); //
 
     // Stack
     
-    void op_toaltstack();
-    void op_fromaltstack();
-    void op_ifdup();
-    void op_depth();
-    void op_drop();
-    void op_dup();
-    void op_nip();
-    void op_over();
-    void op_pick();
-    void op_roll();
-    void op_rot();
-    void op_swap();
-    void op_tuck();
-    void op_2drop();
-    void op_2dup();
-    void op_3dup();
-    void op_2over();
-    void op_2rot();
-    void op_2swap();
+    ScriptError op_toaltstack();
+    ScriptError op_fromaltstack();
+    ScriptError op_ifdup();
+    ScriptError op_depth();
+    ScriptError op_drop();
+    ScriptError op_dup();
+    ScriptError op_nip();
+    ScriptError op_over();
+    ScriptError op_pick();
+    ScriptError op_roll();
+    ScriptError op_rot();
+    ScriptError op_swap();
+    ScriptError op_tuck();
+    ScriptError op_2drop();
+    ScriptError op_2dup();
+    ScriptError op_3dup();
+    ScriptError op_2over();
+    ScriptError op_2rot();
+    ScriptError op_2swap();
 
     // Splice
 
-    void op_cat();
-    void op_substr();
-    void op_left();
-    void op_right();
-    void op_size();
+    ScriptError op_cat();
+    ScriptError op_substr();
+    ScriptError op_left();
+    ScriptError op_right();
+    ScriptError op_size();
 
     // Bitwise Logic
     
-    void op_invert();
-    void op_and();
-    void op_or();
-    void op_xor();
-    void op_equal();
-    void op_equalverify();
+    ScriptError op_invert();
+    ScriptError op_and();
+    ScriptError op_or();
+    ScriptError op_xor();
+    ScriptError op_equal();
+    ScriptError op_equalverify();
 
     // Arithmetic
 
-    void op_1add();
-    void op_1sub();
-    void op_2mul();
-    void op_2div();
-    void op_negate();
-    void op_abs();
-    void op_not();
-    void op_0notequal();
-    void op_add();
-    void op_sub();
-    void op_mul();
-    void op_div();
-    void op_mod();
-    void op_lshift();
-    void op_rshift();
-    void op_booland();
-    void op_boolor();
-    void op_numequal();
-    void op_numequalverify();
-    void op_numnotequal();
-    void op_lessthan();
-    void op_greaterthan();
-    void op_lessthanorequal();
-    void op_greaterthanorequal();
-    void op_min();
-    void op_max();
-    void op_within();
+    ScriptError op_1add();
+    ScriptError op_1sub();
+    ScriptError op_2mul();
+    ScriptError op_2div();
+    ScriptError op_negate();
+    ScriptError op_abs();
+    ScriptError op_not();
+    ScriptError op_0notequal();
+    ScriptError op_add();
+    ScriptError op_sub();
+    ScriptError op_mul();
+    ScriptError op_div();
+    ScriptError op_mod();
+    ScriptError op_lshift();
+    ScriptError op_rshift();
+    ScriptError op_booland();
+    ScriptError op_boolor();
+    ScriptError op_numequal();
+    ScriptError op_numequalverify();
+    ScriptError op_numnotequal();
+    ScriptError op_lessthan();
+    ScriptError op_greaterthan();
+    ScriptError op_lessthanorequal();
+    ScriptError op_greaterthanorequal();
+    ScriptError op_min();
+    ScriptError op_max();
+    ScriptError op_within();
 
     // Crypto
 
-    void op_ripemd160();
-    void op_sha1();
-    void op_sha256();
-    void op_hash160();
-    void op_hash256();
-    void op_codeseparator(); //
-    void op_checksig(); //
-    void op_checksigverify(); //
-    void op_checkmultisigverify(); //
+    ScriptError op_ripemd160();
+    ScriptError op_sha1();
+    ScriptError op_sha256();
+    ScriptError op_hash160();
+    ScriptError op_hash256();
+    ScriptError op_codeseparator(); //
+    ScriptError op_checksig(); //
+    ScriptError op_checksigverify(); //
+    ScriptError op_checkmultisigverify(); //
 
     // Locktime
     
-    void op_checklocktimeverify(); //
-    void op_checksequenceverify(); //
-    void op_nop2();
-    void op_nop3();
+    ScriptError op_checklocktimeverify(); //
+    ScriptError op_checksequenceverify(); //
+    ScriptError op_nop2();
+    ScriptError op_nop3();
 
     // Pseudo-words
 
-    void op_pubkeyhash();
-    void op_pubkey();
-    void op_invalidopcode();
+    ScriptError op_pubkeyhash();
+    ScriptError op_pubkey();
+    ScriptError op_invalidopcode();
 
     // Reserverd words
 
-    void op_reserved();
-    void op_ver();
-    void op_verif();
-    void op_vernotif();
-    void op_reserved1();
-    void op_reserved2();
-    void op_nop1();
-    void op_nop4();
-    void op_nop5();
-    void op_nop6();
-    void op_nop7();
-    void op_nop8();
-    void op_nop9();
-    void op_nop10();
+    ScriptError op_reserved();
+    ScriptError op_ver();
+    ScriptError op_verif();
+    ScriptError op_vernotif();
+    ScriptError op_reserved1();
+    ScriptError op_reserved2();
+    ScriptError op_nop1();
+    ScriptError op_nop4();
+    ScriptError op_nop5();
+    ScriptError op_nop6();
+    ScriptError op_nop7();
+    ScriptError op_nop8();
+    ScriptError op_nop9();
+    ScriptError op_nop10();
 
     /////////////////////////////////////////////////////////
 };
@@ -0,0 +1,91 @@
+#include "ScriptAnalysis.hpp"
+#include "Script.hpp"
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/script/interpreter.cpp#L431
+static bool IsDisabled(uint8_t opcode) {
+    switch (opcode) {
+        case OP_CAT:    case OP_SUBSTR: case OP_LEFT:   case OP_RIGHT:
+        case OP_INVERT: case OP_AND:    case OP_OR:     case OP_XOR:
+        case OP_2MUL:   case OP_2DIV:   case OP_MUL:    case OP_DIV:
+        case OP_MOD:    case OP_LSHIFT: case OP_RSHIFT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+ScriptError ScriptAnalysis::GetError() const {
+    if (size > MAX_SCRIPT_SIZE)                 return SCRIPT_ERR_SCRIPT_SIZE;
+    if (max_push_size > MAX_STACK_ELEMENT_SIZE) return SCRIPT_ERR_PUSH_SIZE;
+    if (op_count > MAX_OP_PER_SCRIPT)           return SCRIPT_ERR_OP_COUNT;
+    if (has_disabled_op)                        return SCRIPT_ERR_DISABLED_OPCODE;
+    if (has_bad_op || truncated)                return SCRIPT_ERR_BAD_OPCODE;
+    if (!balanced)                              return SCRIPT_ERR_UNBALANCED_CONDITIONAL;
+    return SCRIPT_ERR_OK;
+}
+
+ScriptAnalysis Script::Analyze(std::span<const uint8_t> script) {
+    ScriptAnalysis result;
+    result.size        = script.size();
+    result.unspendable = (!script.empty() && script.front() == OP_RETURN)
+                      || script.size() > MAX_SCRIPT_SIZE;
+
+    const uint8_t* pc  = script.data();
+    const uint8_t* end = script.data() + script.size();
+    const uint8_t* data;
+    uint32_t data_size;
+    uint8_t  opcode;
+    uint8_t  last_opcode = OP_INVALIDOPCODE;
+    size_t   depth = 0; // conditional nesting depth
+
+    while (pc < end) {
+        if (!GetOp(pc, end, opcode, data, data_size)) {
+            result.truncated = true;
+            break;
+        }
+        result.max_push_size = std::max(result.max_push_size, data_size);
+
+        if (opcode > OP_16) {
+            result.push_only = false;
+            result.op_count++;
+        }
+        if (IsDisabled(opcode))
+            result.has_disabled_op = true;
+
+        switch (opcode) {
+            case OP_CHECKSIG:
+            case OP_CHECKSIGVERIFY:
+                result.sigops_legacy++;
+                result.sigops_accurate++;
+                break;
+            case OP_CHECKMULTISIG:
+            case OP_CHECKMULTISIGVERIFY:
+                result.sigops_legacy += MAX_PUBKEYS_PER_MULTISIG;
+                result.sigops_accurate += (last_opcode >= OP_1 && last_opcode <= OP_16)
+                    ? last_opcode - (OP_1 - 1)
+                    : MAX_PUBKEYS_PER_MULTISIG;
+                break;
+            case OP_VERIF:
+            case OP_VERNOTIF:
+                result.has_bad_op = true;
+                break;
+            case OP_IF:
+            case OP_NOTIF:
+                depth++;
+                break;
+            case OP_ELSE:
+                if (depth == 0) result.balanced = false;
+                break;
+            case OP_ENDIF:
+                if (depth == 0) result.balanced = false;
+                else depth--;
+                break;
+        }
+        last_opcode = opcode;
+    }
+
+    if (depth != 0)
+        result.balanced = false;
+
+    return result;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ScriptError.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+// Summary of a single linear pass over a script's bytes (see Script::Analyze).
+// Everything in here is known without executing the script, so it can be
+// used to reject malformed scripts before they ever reach the Interpreter.
+struct ScriptAnalysis {
+    size_t   size            = 0;     // Script size in bytes.
+    uint32_t op_count        = 0;     // OPs counted toward MAX_OP_PER_SCRIPT.
+    uint32_t sigops_legacy   = 0;     // OP_CHECKMULTISIG(VERIFY) counted as 20.
+    uint32_t sigops_accurate = 0;     // OP_CHECKMULTISIG(VERIFY) counted as the preceding OP_N.
+    uint32_t max_push_size   = 0;     // Largest data push, in bytes.
+    bool     push_only       = true;  // Only data pushes and OP_0..OP_16 / OP_1NEGATE.
+    bool     unspendable     = false; // Starts with OP_RETURN or exceeds MAX_SCRIPT_SIZE.
+    bool     has_disabled_op = false; // Fails even inside an unexecuted branch.
+    bool     has_bad_op      = false; // OP_VERIF / OP_VERNOTIF, same as above.
+    bool     truncated       = false; // A push runs past the end of the script.
+    bool     balanced        = true;  // OP_IF/OP_NOTIF/OP_ELSE/OP_ENDIF properly nested.
+
+    // First statically detectable consensus violation, SCRIPT_ERR_OK if none.
+    ScriptError GetError() const;
+    bool        IsWellFormed() const { return GetError() == SCRIPT_ERR_OK; }
+};
@@ -0,0 +1,252 @@
+#include "Script.hpp"
+#include "endian.hpp"
+
+#include <sstream>
+#include <cctype>
+#include <stdexcept>
+
+//////////////////////////////// SCRIPT ASM //////////////////////////////////
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/script/script.cpp#L10
+const char* Script::GetOpName(uint8_t opcode) {
+    switch (opcode) {
+        // Constants
+        case OP_0:                      return "0";
+        case OP_PUSHDATA1:              return "OP_PUSHDATA1";
+        case OP_PUSHDATA2:              return "OP_PUSHDATA2";
+        case OP_PUSHDATA4:              return "OP_PUSHDATA4";
+        case OP_1NEGATE:                return "-1";
+        case OP_RESERVED:               return "OP_RESERVED";
+        case OP_1:                      return "1";
+        case OP_2:                      return "2";
+        case OP_3:                      return "3";
+        case OP_4:                      return "4";
+        case OP_5:                      return "5";
+        case OP_6:                      return "6";
+        case OP_7:                      return "7";
+        case OP_8:                      return "8";
+        case OP_9:                      return "9";
+        case OP_10:                     return "10";
+        case OP_11:                     return "11";
+        case OP_12:                     return "12";
+        case OP_13:                     return "13";
+        case OP_14:                     return "14";
+        case OP_15:                     return "15";
+        case OP_16:                     return "16";
+
+        // Flow Control
+        case OP_NOP:                    return "OP_NOP";
+        case OP_VER:                    return "OP_VER";
+        case OP_IF:                     return "OP_IF";
+        case OP_NOTIF:                  return "OP_NOTIF";
+        case OP_VERIF:                  return "OP_VERIF";
+        case OP_VERNOTIF:               return "OP_VERNOTIF";
+        case OP_ELSE:                   return "OP_ELSE";
+        case OP_ENDIF:                  return "OP_ENDIF";
+        case OP_VERIFY:                 return "OP_VERIFY";
+        case OP_RETURN:                 return "OP_RETURN";
+
+        // Stack
+        case OP_TOALTSTACK:             return "OP_TOALTSTACK";
+        case OP_FROMALTSTACK:           return "OP_FROMALTSTACK";
+        case OP_2DROP:                  return "OP_2DROP";
+        case OP_2DUP:                   return "OP_2DUP";
+        case OP_3DUP:                   return "OP_3DUP";
+        case OP_2OVER:                  return "OP_2OVER";
+        case OP_2ROT:                   return "OP_2ROT";
+        case OP_2SWAP:                  return "OP_2SWAP";
+        case OP_IFDUP:                  return "OP_IFDUP";
+        case OP_DEPTH:                  return "OP_DEPTH";
+        case OP_DROP:                   return "OP_DROP";
+        case OP_DUP:                    return "OP_DUP";
+        case OP_NIP:                    return "OP_NIP";
+        case OP_OVER:                   return "OP_OVER";
+        case OP_PICK:                   return "OP_PICK";
+        case OP_ROLL:                   return "OP_ROLL";
+        case OP_ROT:                    return "OP_ROT";
+        case OP_SWAP:                   return "OP_SWAP";
+        case OP_TUCK:                   return "OP_TUCK";
+
+        // Splice
+        case OP_CAT:                    return "OP_CAT";
+        case OP_SUBSTR:                 return "OP_SUBSTR";
+        case OP_LEFT:                   return "OP_LEFT";
+        case OP_RIGHT:                  return "OP_RIGHT";
+        case OP_SIZE:                   return "OP_SIZE";
+
+        // Bitwise Logic
+        case OP_INVERT:                 return "OP_INVERT";
+        case OP_AND:                    return "OP_AND";
+        case OP_OR:                     return "OP_OR";
+        case OP_XOR:                    return "OP_XOR";
+        case OP_EQUAL:                  return "OP_EQUAL";
+        case OP_EQUALVERIFY:            return "OP_EQUALVERIFY";
+        case OP_RESERVED1:              return "OP_RESERVED1";
+        case OP_RESERVED2:              return "OP_RESERVED2";
+
+        // Arithmetic
+        case OP_1ADD:                   return "OP_1ADD";
+        case OP_1SUB:                   return "OP_1SUB";
+        case OP_2MUL:                   return "OP_2MUL";
+        case OP_2DIV:                   return "OP_2DIV";
+        case OP_NEGATE:                 return "OP_NEGATE";
+        case OP_ABS:                    return "OP_ABS";
+        case OP_NOT:                    return "OP_NOT";
+        case OP_0NOTEQUAL:              return "OP_0NOTEQUAL";
+        case OP_ADD:                    return "OP_ADD";
+        case OP_SUB:                    return "OP_SUB";
+        case OP_MUL:                    return "OP_MUL";
+        case OP_DIV:                    return "OP_DIV";
+        case OP_MOD:                    return "OP_MOD";
+        case OP_LSHIFT:                 return "OP_LSHIFT";
+        case OP_RSHIFT:                 return "OP_RSHIFT";
+        case OP_BOOLAND:                return "OP_BOOLAND";
+        case OP_BOOLOR:                 return "OP_BOOLOR";
+        case OP_NUMEQUAL:               return "OP_NUMEQUAL";
+        case OP_NUMEQUALVERIFY:         return "OP_NUMEQUALVERIFY";
+        case OP_NUMNOTEQUAL:            return "OP_NUMNOTEQUAL";
+        case OP_LESSTHAN:               return "OP_LESSTHAN";
+        case OP_GREATERTHAN:            return "OP_GREATERTHAN";
+        case OP_LESSTHANOREQUAL:        return "OP_LESSTHANOREQUAL";
+        case OP_GREATERTHANOREQUAL:     return "OP_GREATERTHANOREQUAL";
+        case OP_MIN:                    return "OP_MIN";
+        case OP_MAX:                    return "OP_MAX";
+        case OP_WITHIN:                 return "OP_WITHIN";
+
+        // Crypto
+        case OP_RIPEMD160:              return "OP_RIPEMD160";
+        case OP_SHA1:                   return "OP_SHA1";
+        case OP_SHA256:                 return "OP_SHA256";
+        case OP_HASH160:                return "OP_HASH160";
+        case OP_HASH256:                return "OP_HASH256";
+        case OP_CODESEPARATOR:          return "OP_CODESEPARATOR";
+        case OP_CHECKSIG:               return "OP_CHECKSIG";
+        case OP_CHECKSIGVERIFY:         return "OP_CHECKSIGVERIFY";
+        case OP_CHECKMULTISIG:          return "OP_CHECKMULTISIG";
+        case OP_CHECKMULTISIGVERIFY:    return "OP_CHECKMULTISIGVERIFY";
+
+        // Expansion
+        case OP_NOP1:                   return "OP_NOP1";
+        case OP_CHECKLOCKTIMEVERIFY:    return "OP_CHECKLOCKTIMEVERIFY";
+        case OP_CHECKSEQUENCEVERIFY:    return "OP_CHECKSEQUENCEVERIFY";
+        case OP_NOP4:                   return "OP_NOP4";
+        case OP_NOP5:                   return "OP_NOP5";
+        case OP_NOP6:                   return "OP_NOP6";
+        case OP_NOP7:                   return "OP_NOP7";
+        case OP_NOP8:                   return "OP_NOP8";
+        case OP_NOP9:                   return "OP_NOP9";
+        case OP_NOP10:                  return "OP_NOP10";
+
+        case OP_INVALIDOPCODE:          return "OP_INVALIDOPCODE";
+
+        default:
+            return "OP_UNKNOWN";
+    }
+}
+
+// Name -> opcode for FromAsm(), every named OP from OP_NOP up plus
+// OP_RESERVED (smaller ones are numbers or pushes), with and without OP_.
+static const std::unordered_map<std::string, uint8_t>& OpNames() {
+    static const auto names = [] {
+        std::unordered_map<std::string, uint8_t> names;
+        for (unsigned op = 0; op <= OP_NOP10; op++) {
+            if (op < OP_NOP && op != OP_RESERVED)
+                continue;
+            std::string name = Script::GetOpName(op);
+            if (name == "OP_UNKNOWN")
+                continue;
+            names[name] = op;
+            names[name.substr(3)] = op;
+        }
+        // Pre-BIP65/BIP112 names, still used by older vectors.
+        names["OP_NOP2"] = names["NOP2"] = OP_NOP2;
+        names["OP_NOP3"] = names["NOP3"] = OP_NOP3;
+        return names;
+    }();
+    return names;
+}
+
+static bool IsDecimal(const std::string& word) {
+    size_t start = (word[0] == '-') ? 1 : 0;
+    if (word.size() == start)
+        return false;
+    for (size_t i = start; i < word.size(); i++)
+        if (word[i] < '0' || word[i] > '9')
+            return false;
+    return true;
+}
+
+static bool IsHex(const std::string& str) {
+    if (str.empty() || str.size() % 2)
+        return false;
+    for (char c: str)
+        if (!std::isxdigit((unsigned char)c))
+            return false;
+    return true;
+}
+
+// Minimal push of `data` (Bitcoin Core's CScript << std::vector), unlike
+// operator<< this doesn't stop at MAX_STACK_ELEMENT_SIZE, oversized pushes
+// are valid test material.
+static void AppendPush(std::pmr::vector<uint8_t>& exec, const std::vector<uint8_t>& data) {
+    size_t  size = data.size();
+    uint8_t push[5];
+    size_t  push_size;
+    if (size < OP_PUSHDATA1) {
+        push[0]   = (uint8_t)size;
+        push_size = 1;
+    } else if (size <= 0xff) {
+        push[0]   = OP_PUSHDATA1;
+        push[1]   = (uint8_t)size;
+        push_size = 2;
+    } else if (size <= 0xffff) {
+        push[0]   = OP_PUSHDATA2;
+        WriteLE16(push + 1, (uint16_t)size);
+        push_size = 3;
+    } else {
+        push[0]   = OP_PUSHDATA4;
+        WriteLE32(push + 1, (uint32_t)size);
+        push_size = 5;
+    }
+    exec.insert(exec.end(), push, push + push_size);
+    exec.insert(exec.end(), data.begin(), data.end());
+}
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/core_read.cpp#L23
+Script Script::FromAsm(const std::string& asm_script) {
+    Script script;
+    std::istringstream words(asm_script);
+    std::string word;
+
+    while (words >> word) {
+        if (IsDecimal(word)) {
+            // Numbers outside of +-0xffffffff are illegal in scripts anyway.
+            if (word.size() > 11)
+                throw std::runtime_error("FromAsm: number out of range: " + word);
+            int64_t n = std::stoll(word);
+            if (n > 0xffffffffLL || n < -0xffffffffLL)
+                throw std::runtime_error("FromAsm: number out of range: " + word);
+            if (n == 0)
+                script.exec.push_back(OP_0);
+            else if (n == -1)
+                script.exec.push_back(OP_1NEGATE);
+            else if (n >= 1 && n <= 16)
+                script.exec.push_back(OP_1 + (n - 1));
+            else
+                AppendPush(script.exec, ScriptNum(n).GetBytes());
+        } else if (word.size() > 2 && word.starts_with("0x") && IsHex(word.substr(2))) {
+            // Raw bytes, inserted as is.
+            auto raw = hex2bytes(word.substr(2));
+            script.exec.insert(script.exec.end(), raw.begin(), raw.end());
+        } else if (word.size() >= 2 && word.front() == '\'' && word.back() == '\'') {
+            AppendPush(script.exec, std::vector<uint8_t>(word.begin() + 1, word.end() - 1));
+        } else if (auto it = OpNames().find(word); it != OpNames().end()) {
+            script.exec.push_back(it->second);
+        } else {
+            throw std::runtime_error("FromAsm: script parse error: " + word);
+        }
+    }
+    return script;
+}
+
+//////////////////////////////////////////////////////////////////////////////
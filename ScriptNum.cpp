@@ -4,36 +4,40 @@ ScriptNum::ScriptNum(const int64_t& num) {
     num_value = num;
 }
 
-ScriptNum::ScriptNum(const std::vector<uint8_t>& bytes) {
+ScriptNum::ScriptNum(std::span<const uint8_t> bytes) {
     if (bytes.size() > SCRIPT_NUM_MAX_BYTES)
         throw std::invalid_argument("ScriptNum(): number > 4 bytes (overflow)");
     
-    if (bytes.size() > 0)
-        if ((bytes.back() & 0x7f) == 0)
-            if (bytes.size() <= 1 || (bytes[bytes.size() - 2] & 0x80) == 0)
-                throw std::invalid_argument("non-minimally encoded script number");
+    if (!IsMinimal(bytes))
+        throw std::invalid_argument("non-minimally encoded script number");
 
     num_value = FromBytes(bytes);
 }
 
+bool ScriptNum::Parse(std::span<const uint8_t> bytes, ScriptNum& out) {
+    if (bytes.size() > SCRIPT_NUM_MAX_BYTES || !IsMinimal(bytes))
+        return false;
+    out.num_value = FromBytes(bytes);
+    return true;
+}
+
 std::vector<uint8_t> ScriptNum::Serialize(const int64_t& value) {
-    if (value == 0)
-        return std::vector<uint8_t>();
-    std::vector<uint8_t> result;
-    const bool neg = value < 0;
-    uint64_t abs_value = neg ? -value : value;
-    while (abs_value) {
-        result.push_back(abs_value & 0xff);
-        abs_value >>= 8;
-    }
-    if (result.back() & 0x80)
-        result.push_back(neg ? 0x80 : 0x00);
-    else if (neg)
-        result.back() |= 0x80;
-    return result;
+    auto bytes = Encode(value);
+    return std::vector<uint8_t>(bytes.begin(), bytes.end());
 }
 
-int64_t ScriptNum::FromBytes(const std::vector<uint8_t>& bytes) {
+const ScriptNum::Bytes& ScriptNum::Constant(int64_t value) {
+    static constexpr auto constants = [] {
+        std::array<Bytes, 18> table;
+        for (int64_t n = -1; n <= 16; n++)
+            table[n+1] = Encode(n);
+        return table;
+    }();
+    assert(value >= -1 && value <= 16);
+    return constants[value+1];
+}
+
+int64_t ScriptNum::FromBytes(std::span<const uint8_t> bytes) {
     if (bytes.empty())
         return 0;
     int64_t result = 0;
@@ -43,3 +47,11 @@ int64_t ScriptNum::FromBytes(const std::vector<uint8_t>& bytes) {
         return -((int64_t)(result & ~(0x80ULL << (8 * (bytes.size() - 1)))));
     return result;
 }
+
+bool ScriptNum::IsMinimal(std::span<const uint8_t> bytes) {
+    if (bytes.size() > 0)
+        if ((bytes.back() & 0x7f) == 0)
+            if (bytes.size() <= 1 || (bytes[bytes.size() - 2] & 0x80) == 0)
+                return false;
+    return true;
+}
@@ -4,22 +4,43 @@
 #include <limits>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <span>
 #include <cassert>
 
 // https://github.com/bitcoin/bitcoin/blob/v0.10.1/src/script/script.h#L180
 
 
 static const size_t SCRIPT_NUM_MAX_BYTES  = 4;
+static const size_t SCRIPT_NUM_ENC_BYTES  = 9; // 8 magnitude bytes + 1 sign byte
 
 class ScriptNum {
 public:
+    // Minimally encoded number held inline, no heap allocation.
+    struct Bytes {
+        std::array<uint8_t, SCRIPT_NUM_ENC_BYTES> data{};
+        uint8_t                                   size = 0;
+
+        const uint8_t* begin() const { return data.data(); }
+        const uint8_t* end()   const { return data.data() + size; }
+    };
+
+    ScriptNum(): num_value(0) {}
     explicit ScriptNum(const int64_t& num);
-    explicit ScriptNum(const std::vector<uint8_t>& bytes);
+    explicit ScriptNum(std::span<const uint8_t> bytes);
+
+    // Non-throwing decoding, returns false on overflow or non-minimal encoding.
+    static bool Parse(std::span<const uint8_t> bytes, ScriptNum& out);
 
     int64_t              GetInt()   const {return num_value;}
+    Bytes                Encode()   const { return Encode(num_value); }
     std::vector<uint8_t> GetBytes() const { return Serialize(num_value); };
     static std::vector<uint8_t> Serialize(const int64_t& value);
 
+    static constexpr Bytes Encode(int64_t value);
+    // Precomputed encodings of -1..16 (OP_1NEGATE, OP_0..OP_16).
+    static const Bytes& Constant(int64_t value);
+
     inline bool operator==(const int64_t& rhs) const { return num_value == rhs; }
     inline bool operator!=(const int64_t& rhs) const { return num_value != rhs; }
     inline bool operator<=(const int64_t& rhs) const { return num_value <= rhs; }
@@ -69,5 +90,23 @@ public:
 private:
     int64_t num_value;
 
-    static int64_t FromBytes(const std::vector<uint8_t>& bytes);
+    static int64_t FromBytes(std::span<const uint8_t> bytes);
+    static bool    IsMinimal(std::span<const uint8_t> bytes);
 };
+
+constexpr ScriptNum::Bytes ScriptNum::Encode(int64_t value) {
+    Bytes result;
+    if (value == 0)
+        return result;
+    const bool neg = value < 0;
+    uint64_t abs_value = neg ? -(uint64_t)value : value;
+    while (abs_value) {
+        result.data[result.size++] = abs_value & 0xff;
+        abs_value >>= 8;
+    }
+    if (result.data[result.size-1] & 0x80)
+        result.data[result.size++] = neg ? 0x80 : 0x00;
+    else if (neg)
+        result.data[result.size-1] |= 0x80;
+    return result;
+}
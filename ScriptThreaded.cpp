@@ -0,0 +1,283 @@
+#include "Script.hpp"
+#include "hashes.hpp"
+
+///////////////////////// DIRECT-THREADED INTERPRETER ////////////////////////
+
+/*  The script is decoded once into a flat array of ThreadedOp, each holding
+    the address of its handler, and the handlers jump straight to the next
+    one (computed goto) instead of returning to a central dispatch loop.
+    Conditionals are resolved at decode time into jumps, so there is no
+    run_this stack at all: a false OP_IF jumps past its OP_ELSE/OP_ENDIF and
+    an executed OP_ELSE jumps past the next one.
+    Run() has already rejected anything Analyze() flags (sizes, OP count,
+    disabled OPs, unbalanced conditionals), so decoding can't fail on those.
+    Small OPs are handled inline, everything else goes through the same
+    member function as the reference Interpreter(). */
+
+#if defined(__GNUC__)
+
+// Jump to the next OP's handler.
+#define NEXT() goto *(++ip)->label
+// Same, after an OP that may have grown the stack.
+#define NEXT_GROWN()                                            \
+    do {                                                        \
+        if (stack.size() + alt_stack.size() > MAX_STACK_SIZE)   \
+            return SCRIPT_ERR_STACK_SIZE;                       \
+        NEXT();                                                 \
+    } while (0)
+
+ScriptError Script::ThreadedInterpreter(std::span<const uint8_t> script, std::vector<ThreadedOp>& code) {
+
+    if (code.empty()) {
+        const uint8_t*      pc  = script.data();
+        const uint8_t*      end = script.data() + script.size();
+        const uint8_t*      data;
+        uint32_t            data_size;
+        uint8_t             opcode;
+        std::vector<size_t> conditionals; // open OP_IF/OP_NOTIF/OP_ELSE
+
+        code.reserve(script.size() + 1);
+        while (pc < end) {
+            if (!GetOp(pc, end, opcode, data, data_size)) {
+                code.clear();
+                return SCRIPT_ERR_BAD_OPCODE;
+            }
+
+            ThreadedOp op{&&do_generic, nullptr,
+                          (uint32_t)(data - script.data()), data_size, 0, opcode};
+
+            switch (opcode) {
+                case OP_PUSHDATA1: case OP_PUSHDATA2: case OP_PUSHDATA4:
+                    op.label = &&do_push; break;
+                case OP_1NEGATE:
+                    op.label = &&do_const; op.size = (uint32_t)-1; break;
+                case OP_1:  case OP_2:  case OP_3:  case OP_4:
+                case OP_5:  case OP_6:  case OP_7:  case OP_8:
+                case OP_9:  case OP_10: case OP_11: case OP_12:
+                case OP_13: case OP_14: case OP_15: case OP_16:
+                    op.label = &&do_const; op.size = opcode - (OP_1 - 1); break;
+                case OP_NOP:  case OP_NOP1: case OP_NOP2: case OP_NOP3:
+                case OP_NOP4: case OP_NOP5: case OP_NOP6: case OP_NOP7:
+                case OP_NOP8: case OP_NOP9: case OP_NOP10:
+                    op.label = &&do_nop; break;
+                case OP_IF:
+                case OP_NOTIF:
+                    op.label = &&do_if;
+                    conditionals.push_back(code.size());
+                    break;
+                case OP_ELSE:
+                    if (conditionals.empty()) {
+                        code.clear();
+                        return SCRIPT_ERR_UNBALANCED_CONDITIONAL;
+                    }
+                    op.label = &&do_else;
+                    code[conditionals.back()].jump = code.size() + 1;
+                    conditionals.back() = code.size();
+                    break;
+                case OP_ENDIF:
+                    if (conditionals.empty()) {
+                        code.clear();
+                        return SCRIPT_ERR_UNBALANCED_CONDITIONAL;
+                    }
+                    op.label = &&do_nop;
+                    code[conditionals.back()].jump = code.size() + 1;
+                    conditionals.pop_back();
+                    break;
+                case OP_VERIFY:         op.label = &&do_verify;         break;
+                case OP_RETURN:         op.label = &&do_return;         break;
+                case OP_DROP:           op.label = &&do_drop;           break;
+                case OP_DUP:            op.label = &&do_dup;            break;
+                case OP_OVER:           op.label = &&do_over;           break;
+                case OP_SWAP:           op.label = &&do_swap;           break;
+                case OP_2DROP:          op.label = &&do_2drop;          break;
+                case OP_2DUP:           op.label = &&do_2dup;           break;
+                case OP_SIZE:           op.label = &&do_size;           break;
+                case OP_EQUAL:
+                case OP_EQUALVERIFY:    op.label = &&do_equal;          break;
+                case OP_1ADD:
+                case OP_1SUB:           op.label = &&do_1add;           break;
+                case OP_ADD:
+                case OP_SUB:
+                case OP_NUMEQUAL:
+                case OP_NUMEQUALVERIFY:
+                case OP_LESSTHAN:
+                case OP_GREATERTHAN:    op.label = &&do_binary;         break;
+                case OP_HASH160:        op.label = &&do_hash160;        break;
+                case OP_SHA256:         op.label = &&do_sha256;         break;
+                default:
+                    if (opcode < OP_PUSHDATA1) { // OP_0 and direct pushes
+                        op.label = &&do_push;
+                        break;
+                    }
+                    auto it = ScriptInterface.find((OpEnum)opcode);
+                    if (it == ScriptInterface.end())
+                        op.label = &&do_bad;
+                    else op.op = it->second.second;
+            }
+            code.push_back(op);
+        }
+        if (!conditionals.empty()) {
+            code.clear();
+            return SCRIPT_ERR_UNBALANCED_CONDITIONAL;
+        }
+        code.push_back({&&do_end, nullptr, 0, 0, 0, OP_INVALIDOPCODE});
+    }
+
+    const ThreadedOp* ip = code.data();
+    ScriptNum lhs, rhs;
+    goto *ip->label;
+
+do_push:
+    stack.emplace_back(script.data() + ip->offset, script.data() + ip->offset + ip->size);
+    NEXT_GROWN();
+
+do_const:
+    PushNum(ScriptNum::Constant((int32_t)ip->size));
+    NEXT_GROWN();
+
+do_nop:
+    NEXT();
+
+do_if: // OP_IF, OP_NOTIF
+    if (stack.empty())
+        return SCRIPT_ERR_UNBALANCED_CONDITIONAL;
+    if (CastAsBool(stack.back()) != (ip->opcode == OP_IF)) {
+        stack.pop_back();
+        ip = code.data() + ip->jump;
+        goto *ip->label;
+    }
+    stack.pop_back();
+    NEXT();
+
+do_else: // only reached from an executed branch
+    ip = code.data() + ip->jump;
+    goto *ip->label;
+
+do_verify:
+    if (stack.empty())
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    if (!CastAsBool(stack.back()))
+        return SCRIPT_ERR_VERIFY;
+    stack.pop_back();
+    NEXT();
+
+do_return:
+    return SCRIPT_ERR_OP_RETURN;
+
+do_drop:
+    if (stack.empty())
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.pop_back();
+    NEXT();
+
+do_dup:
+    if (stack.empty())
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.push_back(stack.back());
+    NEXT_GROWN();
+
+do_over:
+    if (stack.size() < 2)
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.push_back(stack.end()[-2]);
+    NEXT_GROWN();
+
+do_swap:
+    if (stack.size() < 2)
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    std::swap(stack.end()[-1], stack.end()[-2]);
+    NEXT();
+
+do_2drop:
+    if (stack.size() < 2)
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.resize(stack.size() - 2);
+    NEXT();
+
+do_2dup:
+    if (stack.size() < 2)
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.push_back(stack.end()[-2]);
+    stack.push_back(stack.end()[-2]);
+    NEXT_GROWN();
+
+do_size:
+    if (stack.empty())
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    PushNum(ScriptNum(stack.back().size()).Encode());
+    NEXT_GROWN();
+
+do_equal: // OP_EQUAL, OP_EQUALVERIFY
+    if (stack.size() < 2)
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    if (ip->opcode == OP_EQUALVERIFY) {
+        if (stack.end()[-2] != stack.end()[-1])
+            return SCRIPT_ERR_EQUALVERIFY;
+        stack.resize(stack.size() - 2);
+        NEXT();
+    }
+    ReplaceNum(2, ScriptNum(stack.end()[-2] == stack.end()[-1]));
+    NEXT();
+
+do_1add: // OP_1ADD, OP_1SUB
+    if (stack.empty())
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    if (!PeekNum(1, lhs))
+        return SCRIPT_ERR_UNKNOWN_ERROR;
+    ReplaceNum(1, ip->opcode == OP_1ADD ? lhs+1 : lhs-1);
+    NEXT();
+
+do_binary: // two ScriptNum operands
+    if (stack.size() < 2)
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    if (!PeekNum(2, lhs) || !PeekNum(1, rhs))
+        return SCRIPT_ERR_UNKNOWN_ERROR;
+    if (ip->opcode == OP_ADD)              ReplaceNum(2, lhs+rhs);
+    else if (ip->opcode == OP_SUB)         ReplaceNum(2, lhs-rhs);
+    else if (ip->opcode == OP_LESSTHAN)    ReplaceNum(2, ScriptNum(lhs < rhs));
+    else if (ip->opcode == OP_GREATERTHAN) ReplaceNum(2, ScriptNum(lhs > rhs));
+    else if (ip->opcode == OP_NUMEQUAL)    ReplaceNum(2, ScriptNum(lhs == rhs));
+    else {
+        if (lhs != rhs)
+            return SCRIPT_ERR_NUMEQUALVERIFY;
+        stack.resize(stack.size() - 2);
+    }
+    NEXT();
+
+do_hash160:
+    if (stack.empty())
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.back() = hash160(stack.back());
+    NEXT();
+
+do_sha256:
+    if (stack.empty())
+        return SCRIPT_ERR_INVALID_STACK_OPERATION;
+    stack.back() = sha256(stack.back());
+    NEXT();
+
+do_generic:
+    if (auto error = (this->*ip->op)())
+        return error;
+    NEXT_GROWN();
+
+do_bad:
+    return SCRIPT_ERR_BAD_OPCODE;
+
+do_end:
+    return SCRIPT_ERR_OK;
+}
+
+#undef NEXT
+#undef NEXT_GROWN
+
+#else
+
+// No computed goto, use the reference interpreter.
+ScriptError Script::ThreadedInterpreter(std::span<const uint8_t> script, std::vector<ThreadedOp>&) {
+    return Interpreter(script);
+}
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,36 @@
+#include "SocketWriter.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+SocketWriter::~SocketWriter() {
+    try { Flush(); } catch (...) {}
+}
+
+void SocketWriter::Flush() {
+    size_t pending = used;
+    used = 0;
+    Send({buffer.data(), pending});
+}
+
+void SocketWriter::Send(std::span<const uint8_t> bytes) {
+    while (!bytes.empty()) {
+        // send() for sockets (no SIGPIPE), write() for anything else.
+        ssize_t sent = ::send(fd, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+        if (sent < 0 && errno == ENOTSOCK)
+            sent = ::write(fd, bytes.data(), bytes.size());
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "SocketWriter");
+        }
+        bytes = bytes.subspan(sent);
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "serialize.hpp"
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+/* Stream buffering writes to a file descriptor (socket, pipe or file), so
+   serializing a message costs a send() per `capacity` bytes rather than one
+   per field. Flush() sends what's left; the destructor does too but can't
+   report errors, so call it explicitly. Throws std::runtime_error when the
+   descriptor fails. */
+class SocketWriter {
+public:
+    explicit SocketWriter(int fd, size_t capacity = 64 * 1024):
+        fd(fd), buffer(capacity) {}
+    ~SocketWriter();
+
+    SocketWriter(const SocketWriter&)            = delete;
+    SocketWriter& operator=(const SocketWriter&) = delete;
+
+    void WriteBytes(std::span<const uint8_t> bytes) {
+        if (bytes.size() > buffer.size() - used) {
+            Flush();
+            if (bytes.size() >= buffer.size()) { // too big to buffer anyway
+                Send(bytes);
+                return;
+            }
+        }
+        std::memcpy(buffer.data() + used, bytes.data(), bytes.size());
+        used += bytes.size();
+    }
+
+    void Flush();
+
+private:
+    int                  fd;
+    std::vector<uint8_t> buffer;
+    size_t               used = 0;
+
+    void Send(std::span<const uint8_t> bytes);
+};
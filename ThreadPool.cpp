@@ -0,0 +1,77 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threads) {
+    for (size_t worker = 1; worker < std::max<size_t>(threads, 1); worker++)
+        workers.emplace_back([this, worker] { Work(worker); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    start.notify_all();
+    for (auto& worker: workers)
+        worker.join();
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t, size_t)>& fn,
+                             size_t grain) {
+    if (count == 0)
+        return;
+    {
+        std::lock_guard lock(mutex);
+        this->job   = &fn;
+        this->count = count;
+        this->grain = std::max<size_t>(grain, 1);
+        this->next  = 0;
+        this->error = nullptr;
+        active      = workers.size();
+        generation++;
+    }
+    start.notify_all();
+    Run(0);
+
+    std::unique_lock lock(mutex);
+    done.wait(lock, [this] { return active == 0; });
+    job = nullptr;
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void ThreadPool::Work(size_t worker) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock lock(mutex);
+            start.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+        Run(worker);
+        std::lock_guard lock(mutex);
+        if (--active == 0)
+            done.notify_one();
+    }
+}
+
+void ThreadPool::Run(size_t worker) {
+    for (;;) {
+        size_t begin = next.fetch_add(grain);
+        if (begin >= count)
+            return;
+        try {
+            for (size_t i = begin; i < std::min(begin + grain, count); i++)
+                (*job)(i, worker);
+        } catch (...) {
+            std::lock_guard lock(mutex);
+            if (!error)
+                error = std::current_exception();
+            next = count; // stop handing out work
+            return;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+/* Fixed set of worker threads for data-parallel loops. The calling thread
+   takes part as worker 0, so a pool of 1 runs everything inline. Workers
+   sleep between loops, a pool is meant to be created once and reused.
+   ParallelFor isn't reentrant (no nested loops from `fn`) and one thread at
+   a time may call it. */
+class ThreadPool {
+public:
+    // Defaults to one thread per core.
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Threads running a loop, the caller included.
+    size_t Size() const { return workers.size() + 1; }
+
+    // fn(i, worker) for every i < count, handed out `grain` at a time to
+    // whichever thread is free, `worker` (< Size()) telling them apart for
+    // per-thread state. Returns once all are done, rethrowing the first
+    // exception thrown by `fn` (the remaining indices are then skipped).
+    void ParallelFor(size_t count, const std::function<void(size_t i, size_t worker)>& fn,
+                     size_t grain = 1);
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex               mutex;
+    std::condition_variable  start;
+    std::condition_variable  done;
+    bool                     stopping   = false;
+    uint64_t                 generation = 0; // loops started, wakes the workers
+    size_t                   active     = 0; // workers not done with the current loop
+
+    // Current loop.
+    const std::function<void(size_t, size_t)>* job = nullptr;
+    size_t                                     count = 0;
+    size_t                                     grain = 1;
+    std::atomic<size_t>                        next  = 0;
+    std::exception_ptr                         error;
+
+    void Work(size_t worker);
+    void Run(size_t worker);
+};
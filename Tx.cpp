@@ -1,109 +1,115 @@
 #include "Tx.hpp"
 
-Tx::Tx(const std::vector<uint8_t>& serialized_tx) {
-
-    auto ser_it = serialized_tx.begin();
-
-    // Version
-    if (serialized_tx.size() < 4)
-        throw std::runtime_error("Transaction: invalid input size");
-    std::memcpy(&version, serialized_tx.data(), 4);
-    ser_it += 4;
-
-    // Number of inputs
-    CompactSize n_inputs_cs(std::vector<uint8_t>(ser_it, serialized_tx.end()));
-    auto n_inputs = n_inputs_cs.GetInt();
-    ser_it += n_inputs_cs.GetBytes().size();
-
-    // Inputs
-    inputs.reserve(n_inputs);
-    for (size_t i = 0; i < n_inputs; i++) {
-        TxIn in(std::vector<uint8_t>(ser_it, serialized_tx.end()));
-        ser_it += in.__offset;
-        inputs.push_back(in);
-    }
+#include <algorithm>
+
+Tx::Tx(std::span<const uint8_t> serialized_tx, std::pmr::memory_resource* resource):
+    inputs(resource), outputs(resource) {
+    Reader reader(serialized_tx);
+    Unserialize(reader);
+    if (!reader.Empty())
+        throw std::runtime_error("Transaction: trailing data");
+}
 
-    // Number of outputs
-    CompactSize n_outputs_cs(std::vector<uint8_t>(ser_it, serialized_tx.end()));
-    auto n_outputs = n_outputs_cs.GetInt();
-    ser_it += n_outputs_cs.GetBytes().size();
-
-    // Outputs
-    outputs.reserve(n_outputs);
-    for (size_t i = 0; i < n_outputs; i++) {
-        TxOut out(std::vector<uint8_t>(ser_it, serialized_tx.end()));
-        ser_it += out.__offset;
-        outputs.push_back(out);
-    }
+std::vector<uint8_t> Tx::Serialize() const {
+    std::vector<uint8_t> serialized(GetSerializedSize());
+    Serialize(serialized);
+    return serialized;
+}
 
-    // Locktime
-    if (std::vector<uint8_t>(ser_it, serialized_tx.end()).size() < 4)
-        throw std::runtime_error("Transaction: invalid input size");
-    std::memcpy(&locktime, std::vector<uint8_t>(ser_it, serialized_tx.end()).data(), 4);
-    ser_it += 4;
-
-    std::cout << "Transaction:" << std::endl;
-    std::cout << std::endl;
-    std::cout << "Version: " << version << std::endl << std::endl;
-    std::cout << "Inputs: " << n_inputs << std::endl;
-    for (auto& in: inputs) {
-        std::cout << "    txid          : " << toHex(in.txid) << std::endl;
-        std::cout << "    txid_idx      : " << in.txid_idx << std::endl;
-        std::cout << "    script_length : " << in.unlock_script.GetBytes().size() << std::endl;
-        std::cout << "    script bytes  : " << toHex(in.unlock_script.GetBytes()) << std::endl;
-        std::cout << "    sequence      : " << toHex(int2bytes_LE(in.sequence, 4)) << std::endl;
-        std::cout << std::endl;
-    }
-    std::cout << std::endl;
-    std::cout << "Outputs: " << n_outputs << std::endl;
-    for (auto& out: outputs) {
-        std::cout << "    satoshis   : " << out.satoshis << std::endl;
-        std::cout << "    script_len : " << out.locking_script.GetBytes().size() << std::endl;
-        std::cout << "    script     : " << toHex(out.locking_script.GetBytes()) << std::endl;
-        std::cout << std::endl;
-    }
-    std::cout << "Locktime: " << locktime << std::endl;
+size_t Tx::Serialize(std::span<uint8_t> out) const {
+    Writer writer(out);
+    Serialize(writer);
+    return writer.Position();
+}
 
+bool Tx::HasWitness() const {
+    return std::any_of(inputs.begin(), inputs.end(),
+        [](const TxIn& in) { return !in.witness.empty(); });
 }
 
-std::vector<uint8_t> Tx::Serialize() {
-    std::vector<uint8_t> serialized;
+Tx& Tx::SetVersion(int32_t version) {
+    this->version = version;
+    Invalidate();
+    return *this;
+}
 
-    // Version
-    auto version_bytes = int2bytes_LE(version, 4);
-    serialized.insert(serialized.end(),
-                      std::move_iterator(version_bytes.begin()),
-                      std::move_iterator(version_bytes.end()));
+Tx& Tx::SetLockTime(uint32_t locktime) {
+    this->locktime = locktime;
+    Invalidate();
+    return *this;
+}
 
-    // Inputs
-    auto n_inputs = CompactSize(inputs.size()).GetBytes();
-    serialized.insert(serialized.end(),
-                      std::move_iterator(n_inputs.begin()),
-                      std::move_iterator(n_inputs.end()));
-    for (auto& in: inputs) {
-        std::vector<uint8_t> in_ser = in.Serialize();
-        serialized.insert(serialized.end(),
-                          std::move_iterator(in_ser.begin()),
-                          std::move_iterator(in_ser.end()));
-    }
+Tx& Tx::AddInput(TxIn input) {
+    inputs.push_back(std::move(input));
+    Invalidate();
+    return *this;
+}
+
+Tx& Tx::AddOutput(TxOut output) {
+    outputs.push_back(std::move(output));
+    Invalidate();
+    return *this;
+}
+
+Tx& Tx::SetInput(size_t i, TxIn input) {
+    inputs.at(i) = std::move(input);
+    Invalidate();
+    return *this;
+}
+
+Tx& Tx::SetOutput(size_t i, TxOut output) {
+    outputs.at(i) = std::move(output);
+    Invalidate();
+    return *this;
+}
+
+Tx& Tx::SetScriptSig(size_t i, Script script_sig) {
+    inputs.at(i).unlock_script = std::move(script_sig);
+    Invalidate();
+    return *this;
+}
+
+// The txid and stripped size don't cover witnesses, they stay valid.
+Tx& Tx::SetWitness(size_t i, Witness witness) {
+    inputs.at(i).witness = std::move(witness);
+    wtxid.reset();
+    size.reset();
+    return *this;
+}
 
-    // Outputs
-    auto n_outputs = CompactSize(outputs.size()).GetBytes();
-    serialized.insert(serialized.end(),
-                      std::move_iterator(n_outputs.begin()),
-                      std::move_iterator(n_outputs.end()));
-    for (auto& out: outputs) {
-        std::vector<uint8_t> out_ser = out.Serialize();
-        serialized.insert(serialized.end(),
-                          std::move_iterator(out_ser.begin()),
-                          std::move_iterator(out_ser.end()));
+void Tx::Invalidate() {
+    txid.reset();
+    wtxid.reset();
+    size.reset();
+    stripped_size.reset();
+}
+
+const Hash256& Tx::GetTxId() const {
+    if (!txid) {
+        HashWriter hasher;
+        Serialize(hasher, false);
+        txid = hasher.GetHash();
     }
+    return *txid;
+}
 
-    // Locktime
-    auto locktime_bytes = int2bytes_LE(locktime, 4);
-    serialized.insert(serialized.end(),
-                      std::move_iterator(locktime_bytes.begin()),
-                      std::move_iterator(locktime_bytes.end()));
+const Hash256& Tx::GetWTxId() const {
+    if (!wtxid)
+        wtxid = HasWitness() ? SerializeHash(*this) : GetTxId();
+    return *wtxid;
+}
 
-    return serialized;
+size_t Tx::GetSerializedSize() const {
+    if (!size)
+        size = GetSerializeSize(*this);
+    return *size;
+}
+
+size_t Tx::GetStrippedSize() const {
+    if (!stripped_size) {
+        SizeComputer counter;
+        Serialize(counter, false);
+        stripped_size = counter.Size();
+    }
+    return *stripped_size;
 }
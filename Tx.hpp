@@ -2,6 +2,9 @@
 
 #include "Script.hpp"
 #include "CompactSize.hpp"
+#include "Reader.hpp"
+#include "Writer.hpp"
+#include "HashWriter.hpp"
 #include "utils.hpp"
 
 #include "TxIn.hpp"
@@ -9,26 +12,143 @@
 
 #include <iostream>
 #include <vector>
+#include <optional>
 
 class Tx {
 public:
-    int32_t            version;
-    std::vector<TxIn>  inputs;
-    std::vector<TxOut> outputs;
-    uint32_t           locktime;
-
     Tx() = delete;
 
-    Tx(const int32_t&            version,
-                const std::vector<TxIn>&  inputs,
-                const std::vector<TxOut>& outputs,
-                const uint32_t&           locktime):
-                version(version),
-                inputs(inputs),
-                outputs(outputs),
-                locktime(locktime) {}
+    Tx(int32_t                 version,
+       std::pmr::vector<TxIn>  inputs,
+       std::pmr::vector<TxOut> outputs,
+       uint32_t                locktime):
+       version(version),
+       inputs(std::move(inputs)),
+       outputs(std::move(outputs)),
+       locktime(locktime) {}
+
+    // Parse a whole serialized transaction (legacy or BIP144 segwit), or
+    // consume one from `s` (e.g. a Reader out of a block). Either way the
+    // bytes are walked once, in place.
+    // Every vector and script is allocated from `resource`. With an arena
+    // (std::pmr::monotonic_buffer_resource) shared by a whole block, its
+    // transactions end up in a few contiguous chunks, freed all at once with
+    // the arena, which must then outlive them. Copies of a Tx use the default
+    // resource again.
+    explicit Tx(std::span<const uint8_t>   serialized_tx,
+                std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    template <InStream Stream>
+    explicit Tx(Stream& s, std::pmr::memory_resource* resource = std::pmr::get_default_resource()):
+        inputs(resource), outputs(resource) { Unserialize(s); }
+
+    // Serialization with witnesses (if any), allocated once / into `out` (at
+    // least GetSerializedSize() bytes, returns how many were written) / to
+    // any stream, or without them for the legacy format.
+    std::vector<uint8_t> Serialize() const;
+    size_t               Serialize(std::span<uint8_t> out) const;
+
+    int32_t                   GetVersion()  const { return version; }
+    const std::pmr::vector<TxIn>&  GetInputs()   const { return inputs; }
+    const std::pmr::vector<TxOut>& GetOutputs()  const { return outputs; }
+    uint32_t                  GetLockTime() const { return locktime; }
+    bool                      HasWitness()  const;
+    // A single input spending the null outpoint.
+    bool                      IsCoinBase()  const { return inputs.size() == 1 && inputs[0].prevout.IsNull(); }
+
+    // Builder, chainable. Changes only go through here so that the cached
+    // ids and sizes below get dropped whenever they would be affected.
+    Tx& SetVersion(int32_t version);
+    Tx& SetLockTime(uint32_t locktime);
+    Tx& AddInput(TxIn input);
+    Tx& AddOutput(TxOut output);
+    Tx& SetInput(size_t i, TxIn input);
+    Tx& SetOutput(size_t i, TxOut output);
+    Tx& SetScriptSig(size_t i, Script script_sig);
+    Tx& SetWitness(size_t i, Witness witness);
+
+    // hash256 of the legacy serialization / of the full one, serialized order.
+    // Like the sizes below they are computed on first request (sizes are
+    // already known after parsing) and kept until the next change. Filling
+    // the cache isn't thread-safe, query once before sharing a Tx.
+    const Hash256& GetTxId()  const;
+    const Hash256& GetWTxId() const;
+
+    // BIP141 sizes: full serialization / without marker, flag and witnesses /
+    // weight units / virtual bytes.
+    size_t GetSerializedSize() const;
+    size_t GetStrippedSize()   const;
+    size_t GetWeight()         const { return GetStrippedSize() * 3 + GetSerializedSize(); }
+    size_t GetVirtualSize()    const { return (GetWeight() + 3) / 4; }
+
+    // https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/primitives/transaction.h#L237
+    template <OutStream Stream>
+    void Serialize(Stream& s, bool with_witness = true) const {
+        ::Serialize(s, version);
+        if (with_witness && HasWitness()) {
+            // Marker (an empty input vector to old parsers) and flag.
+            ::SerializeMany(s, (uint8_t)0x00, (uint8_t)0x01, inputs, outputs);
+            for (auto& in: inputs)
+                ::Serialize(s, in.witness);
+        } else
+            ::SerializeMany(s, inputs, outputs);
+        ::Serialize(s, locktime);
+    }
+
+    // https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/primitives/transaction.h#L196
+    template <InStream Stream>
+    void Unserialize(Stream& s) {
+        // Streams that know their position (Reader) give the sizes for free.
+        constexpr bool positioned = requires { s.Position(); };
+        [[maybe_unused]] size_t start = 0, witness_start = 0;
+        if constexpr (positioned)
+            start = s.Position();
+
+        ::Unserialize(s, version);
+        uint8_t flags = 0;
+        ::Unserialize(s, inputs);
+        outputs.clear();
+        if (inputs.empty()) {
+            // Either no inputs and this was the output count, or a marker
+            // followed by the flag.
+            ::Unserialize(s, flags);
+            if (flags != 0)
+                ::UnserializeMany(s, inputs, outputs);
+        } else
+            ::Unserialize(s, outputs);
+
+        size_t witness_size = 0;
+        if (flags & 1) {
+            flags ^= 1;
+            if constexpr (positioned)
+                witness_start = s.Position();
+            for (auto& in: inputs)
+                ::Unserialize(s, in.witness);
+            if (!HasWitness())
+                throw std::runtime_error("Transaction: superfluous witness record");
+            if constexpr (positioned)
+                witness_size = 2 + s.Position() - witness_start; // with marker and flag
+        }
+        if (flags)
+            throw std::runtime_error("Transaction: unknown optional data");
+        ::Unserialize(s, locktime);
+
+        Invalidate();
+        if constexpr (positioned) {
+            size          = s.Position() - start;
+            stripped_size = *size - witness_size;
+        }
+    }
+
+private:
+    int32_t                 version;
+    std::pmr::vector<TxIn>  inputs;
+    std::pmr::vector<TxOut> outputs;
+    uint32_t                locktime;
 
-    Tx(const std::vector<uint8_t>& serialized_tx);
+    mutable std::optional<Hash256> txid;
+    mutable std::optional<Hash256> wtxid;
+    mutable std::optional<size_t>  size;
+    mutable std::optional<size_t>  stripped_size;
 
-    std::vector<uint8_t> Serialize();
-};
+    void Invalidate();
+};
\ No newline at end of file
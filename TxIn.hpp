@@ -1,34 +1,67 @@
 #pragma once
 
 #include "Script.hpp"
+#include "OutPoint.hpp"
 #include "CompactSize.hpp"
+#include "Reader.hpp"
+#include "Writer.hpp"
+
+// BIP141 witness stack.
+using Witness = std::pmr::vector<std::pmr::vector<uint8_t>>;
 
 class TxIn {
 public:
     TxIn() = delete;
 
-    TxIn(const std::vector<uint8_t>& txid,
-         const uint32_t&             txid_idx,
-         const Script&               unlock_script,
-         const uint32_t&             sequence):
-         txid(txid),
-         txid_idx(txid_idx),
-         unlock_script(unlock_script),
-         sequence(sequence) {}
+    TxIn(const OutPoint& prevout,
+         Script          unlock_script,
+         uint32_t        sequence,
+         Witness         witness = {}):
+         prevout(prevout),
+         unlock_script(std::move(unlock_script)),
+         sequence(sequence),
+         witness(std::move(witness)) {}
 
-    TxIn(const std::vector<uint8_t>& serialized);
+    // Consume one serialized input from `s` (e.g. a Reader), allocating its
+    // script and witness from `resource`.
+    template <InStream Stream>
+    explicit TxIn(Stream& s, std::pmr::memory_resource* resource = std::pmr::get_default_resource()):
+        unlock_script(resource), witness(resource) { Unserialize(s); }
 
+    // Serialization, allocated once / into `out` (at least GetSerializedSize()
+    // bytes, returns how many were written) / to any stream. The witness isn't
+    // part of it, Tx writes all of them after the outputs (BIP144).
+    size_t               GetSerializedSize(bool ignore_script=false) const;
     std::vector<uint8_t> Serialize(bool ignore_script=false) const;
+    size_t               Serialize(std::span<uint8_t> out, bool ignore_script=false) const;
+
+    // https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/primitives/transaction.h
+    template <OutStream Stream>
+    void Serialize(Stream& s, bool ignore_script=false) const {
+        ::Serialize(s, prevout);
+        if (ignore_script)
+            WriteCompactSize(s, 0);
+        else
+            ::Serialize(s, unlock_script);
+        ::Serialize(s, sequence);
+    }
+
+    template <InStream Stream>
+    void Unserialize(Stream& s) {
+        ::UnserializeMany(s, prevout, unlock_script, sequence);
+    }
 
-    std::vector<uint8_t> GetTxId()  { return txid; }
-    uint32_t             GetIndex() { return txid_idx; }
+    const OutPoint& GetPrevOut() const { return prevout; }
+    const Hash256&  GetTxId()    const { return prevout.txid; }
+    uint32_t        GetIndex()   const { return prevout.n; }
+    const Script&   GetScript()  const { return unlock_script; }
+
+    const Witness&  GetWitness() const { return witness; }
 private:
-    std::vector<uint8_t> txid;
-    uint32_t             txid_idx;
+    OutPoint             prevout;
     Script               unlock_script;
     uint32_t             sequence;
-
-    size_t               __offset = 0; // used during tx deserialization, a little ugly but eh
+    Witness              witness; // empty for legacy inputs
 
     friend class Tx;
 };
@@ -2,6 +2,8 @@
 
 #include "Script.hpp"
 #include "CompactSize.hpp"
+#include "Reader.hpp"
+#include "Writer.hpp"
 
 class TxOut {
 public:
@@ -10,19 +12,32 @@ public:
     TxOut(int64_t satoshis,
           Script  script_pubkey):
           satoshis(satoshis),
-          locking_script(script_pubkey) {}
+          locking_script(std::move(script_pubkey)) {}
 
-    TxOut(const std::vector<uint8_t>& serialized);
+    // Consume one serialized output from `s` (e.g. a Reader), allocating its
+    // script from `resource`.
+    template <InStream Stream>
+    explicit TxOut(Stream& s, std::pmr::memory_resource* resource = std::pmr::get_default_resource()):
+        locking_script(resource) { Unserialize(s); }
 
+    // Serialization, allocated once / into `out` (at least GetSerializedSize()
+    // bytes, returns how many were written) / to any stream.
+    size_t               GetSerializedSize() const;
     std::vector<uint8_t> Serialize() const;
+    size_t               Serialize(std::span<uint8_t> out) const;
 
-    Script  GetScript()   { return locking_script; }
-    int64_t GetSatoshis() { return satoshis; }
+    // https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/primitives/transaction.h
+    template <OutStream Stream>
+    void Serialize(Stream& s) const { ::SerializeMany(s, satoshis, locking_script); }
+    template <InStream Stream>
+    void Unserialize(Stream& s) { ::UnserializeMany(s, satoshis, locking_script); }
+
+    const Script& GetScript()   const { return locking_script; }
+    int64_t       GetSatoshis() const { return satoshis; }
 
 private:
     int64_t  satoshis; // Amount in satoshis
     Script   locking_script;
-    size_t   __offset = 0;
 
     friend class Tx;
 };
@@ -0,0 +1,176 @@
+#include "TxView.hpp"
+#include "HashWriter.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+TxView::TxView(std::span<const uint8_t> serialized_tx) {
+    Reader reader(serialized_tx);
+    Scan(reader);
+    if (!reader.Empty())
+        throw std::runtime_error("TxView: trailing data");
+}
+
+TxView::TxView(Reader& reader) {
+    Scan(reader);
+}
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/primitives/transaction.h#L201
+void TxView::Scan(Reader& reader) {
+    auto   rest  = reader.Rest();
+    size_t start = reader.Position();
+
+    reader.Read<int32_t>(); // version
+
+    // BIP144: an empty input vector followed by a non-zero flag byte.
+    n_inputs = reader.ReadCompactSize();
+    if (n_inputs == 0 && !reader.Empty() && reader.Rest()[0] != 0x00) {
+        if (reader.Read<uint8_t>() != 0x01)
+            throw std::runtime_error("TxView: unknown transaction optional data");
+        has_witness = true;
+        n_inputs    = reader.ReadCompactSize();
+    }
+
+    // Inputs
+    offsets.reserve(std::min<uint64_t>(n_inputs, reader.Remaining() / 41) + 1);
+    for (size_t i = 0; i < n_inputs; i++) {
+        offsets.push_back(reader.Position() - start);
+        reader.ReadBytes(32 + 4);
+        reader.ReadBytes(reader.ReadCompactSize());
+        reader.Read<uint32_t>();
+    }
+
+    // Outputs
+    n_outputs = reader.ReadCompactSize();
+    for (size_t i = 0; i < n_outputs; i++) {
+        offsets.push_back(reader.Position() - start);
+        reader.Read<int64_t>();
+        reader.ReadBytes(reader.ReadCompactSize());
+    }
+
+    // Witnesses
+    if (has_witness) {
+        bool any_item = false;
+        for (size_t i = 0; i < n_inputs; i++) {
+            offsets.push_back(reader.Position() - start);
+            auto n_items = reader.ReadCompactSize();
+            any_item |= n_items != 0;
+            for (size_t item = 0; item < n_items; item++)
+                reader.ReadBytes(reader.ReadCompactSize());
+        }
+        if (!any_item)
+            throw std::runtime_error("TxView: superfluous witness record");
+    }
+
+    offsets.push_back(reader.Position() - start);
+    reader.Read<uint32_t>(); // locktime
+
+    bytes = rest.first(reader.Position() - start);
+}
+
+std::span<const uint8_t> TxView::Skip(Reader& reader) {
+    auto   rest  = reader.Rest();
+    size_t start = reader.Position();
+
+    reader.ReadBytes(4); // version
+    uint64_t n_inputs  = reader.ReadCompactSize();
+    uint8_t  flags     = 0;
+    uint64_t n_outputs = 0;
+    // Same as Tx::Unserialize: after an empty input vector, either a flag or
+    // an empty output vector.
+    if (n_inputs == 0) {
+        flags = reader.Read<uint8_t>();
+        if (flags != 0)
+            n_inputs = reader.ReadCompactSize();
+    }
+    for (uint64_t i = 0; i < n_inputs; i++) {
+        reader.ReadBytes(32 + 4);
+        reader.ReadBytes(reader.ReadCompactSize() + 4); // script, sequence
+    }
+    if (n_inputs != 0 || flags != 0)
+        n_outputs = reader.ReadCompactSize();
+    for (uint64_t i = 0; i < n_outputs; i++) {
+        reader.ReadBytes(8);
+        reader.ReadBytes(reader.ReadCompactSize());
+    }
+    if (flags & 1)
+        for (uint64_t i = 0; i < n_inputs; i++)
+            for (uint64_t item = reader.ReadCompactSize(); item > 0; item--)
+                reader.ReadBytes(reader.ReadCompactSize());
+    reader.ReadBytes(4); // locktime
+
+    return rest.first(reader.Position() - start);
+}
+
+size_t TxView::StrippedSize() const {
+    if (!has_witness)
+        return bytes.size();
+    return bytes.size() - 2 - (LockTimeOffset() - WitnessOffset(0));
+}
+
+int32_t TxView::Version() const {
+    return At(0).Read<int32_t>();
+}
+
+uint32_t TxView::LockTime() const {
+    return At(LockTimeOffset()).Read<uint32_t>();
+}
+
+std::span<const uint8_t> TxView::PrevTxId(size_t i) const {
+    return bytes.subspan(InputOffset(i), 32);
+}
+
+uint32_t TxView::PrevIndex(size_t i) const {
+    return At(InputOffset(i) + 32).Read<uint32_t>();
+}
+
+std::span<const uint8_t> TxView::ScriptSig(size_t i) const {
+    auto reader = At(InputOffset(i) + 36);
+    return reader.ReadBytes(reader.ReadCompactSize());
+}
+
+uint32_t TxView::Sequence(size_t i) const {
+    auto reader = At(InputOffset(i) + 36);
+    reader.ReadBytes(reader.ReadCompactSize());
+    return reader.Read<uint32_t>();
+}
+
+int64_t TxView::Amount(size_t i) const {
+    return At(OutputOffset(i)).Read<int64_t>();
+}
+
+std::span<const uint8_t> TxView::ScriptPubKey(size_t i) const {
+    auto reader = At(OutputOffset(i) + 8);
+    return reader.ReadBytes(reader.ReadCompactSize());
+}
+
+size_t TxView::WitnessSize(size_t i) const {
+    if (!has_witness)
+        return 0;
+    return At(WitnessOffset(i)).ReadCompactSize();
+}
+
+std::span<const uint8_t> TxView::WitnessItem(size_t i, size_t item) const {
+    auto reader = At(WitnessOffset(i));
+    reader.ReadCompactSize();
+    for (size_t n = 0; n < item; n++)
+        reader.ReadBytes(reader.ReadCompactSize());
+    return reader.ReadBytes(reader.ReadCompactSize());
+}
+
+// Legacy serialization: drop the marker/flag and the witnesses.
+Hash256 TxView::TxId() const {
+    if (!has_witness)
+        return WTxId();
+    HashWriter hasher;
+    hasher.WriteBytes(bytes.first(4));
+    hasher.WriteBytes(bytes.subspan(6, WitnessOffset(0) - 6));
+    hasher.WriteBytes(bytes.subspan(LockTimeOffset()));
+    return hasher.GetHash();
+}
+
+Hash256 TxView::WTxId() const {
+    HashWriter hasher;
+    hasher.WriteBytes(bytes);
+    return hasher.GetHash();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Reader.hpp"
+#include "hashes.hpp"
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+/* Read-only view of a serialized transaction (legacy or BIP144 segwit).
+   A single scan at construction validates the layout and records where each
+   input, output and witness starts; accessors then decode fields in place
+   and return spans into the original bytes, no Script or TxIn/TxOut built.
+   The bytes aren't copied so they must outlive the view, which makes it fit
+   for memory-mapped block files. Indices must be in range (unchecked). */
+class TxView {
+public:
+    // Exactly one transaction, trailing bytes are an error.
+    explicit TxView(std::span<const uint8_t> serialized_tx);
+    // Consume one transaction from `reader` (e.g. the next one in a block).
+    explicit TxView(Reader& reader);
+
+    // Consume one transaction from `reader` going only by its lengths (no
+    // offsets recorded, nothing allocated) and return its bytes: finding
+    // where the transactions of a block start, to parse them in parallel.
+    // Only the framing is checked, Tx / TxView validate the rest.
+    static std::span<const uint8_t> Skip(Reader& reader);
+
+    std::span<const uint8_t> Bytes()       const { return bytes; }
+    size_t                   InputCount()  const { return n_inputs; }
+    size_t                   OutputCount() const { return n_outputs; }
+    bool                     HasWitness()  const { return has_witness; }
+
+    // BIP141 sizes: without marker, flag and witnesses / weight units.
+    size_t StrippedSize() const;
+    size_t Weight()       const { return StrippedSize() * 3 + bytes.size(); }
+
+    int32_t  Version()  const;
+    uint32_t LockTime() const;
+
+    // Inputs
+    std::span<const uint8_t> PrevTxId(size_t i)  const; // 32 bytes, serialized order
+    uint32_t                 PrevIndex(size_t i) const;
+    std::span<const uint8_t> ScriptSig(size_t i) const;
+    uint32_t                 Sequence(size_t i)  const;
+
+    // Outputs
+    int64_t                  Amount(size_t i)       const;
+    std::span<const uint8_t> ScriptPubKey(size_t i) const;
+
+    // Witnesses (empty if the tx has none)
+    size_t                   WitnessSize(size_t i)                const;
+    std::span<const uint8_t> WitnessItem(size_t i, size_t item)   const;
+
+    // hash256 of the legacy serialization / of the whole thing, serialized order.
+    Hash256 TxId()  const;
+    Hash256 WTxId() const;
+
+private:
+    std::span<const uint8_t> bytes;
+    size_t                   n_inputs    = 0;
+    size_t                   n_outputs   = 0;
+    bool                     has_witness = false;
+    // Start of every input, then every output, then (segwit only) every
+    // input's witness, then the locktime.
+    std::vector<uint32_t>    offsets;
+
+    void Scan(Reader& reader);
+
+    // Reader over everything from `offset` on.
+    Reader At(uint32_t offset) const { return Reader(bytes.subspan(offset)); }
+
+    uint32_t InputOffset(size_t i)   const { return offsets[i]; }
+    uint32_t OutputOffset(size_t i)  const { return offsets[n_inputs + i]; }
+    uint32_t WitnessOffset(size_t i) const { return offsets[n_inputs + n_outputs + i]; }
+    uint32_t LockTimeOffset()        const { return offsets.back(); }
+};
@@ -0,0 +1,153 @@
+#include "Uint256.hpp"
+#include "endian.hpp"
+#include "utils.hpp"
+
+#include <stdexcept>
+
+Uint256::Uint256(const Hash256& hash) {
+    for (size_t i = 0; i < limbs.size(); i++)
+        limbs[i] = ReadLE32(hash.data() + 4*i);
+}
+
+Hash256 Uint256::ToHash() const {
+    Hash256 hash;
+    for (size_t i = 0; i < limbs.size(); i++)
+        WriteLE32(hash.data() + 4*i, limbs[i]);
+    return hash;
+}
+
+std::string Uint256::ToString() const {
+    return toDisplayHex(ToHash());
+}
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/arith_uint256.cpp#L203
+Uint256 Uint256::FromCompact(uint32_t bits, bool* negative, bool* overflow) {
+    unsigned exponent = bits >> 24;
+    uint32_t mantissa = bits & 0x007fffff;
+    Uint256  value;
+    // Sign and overflow are of the mantissa once shifted, as in Core: bytes
+    // shifted out don't count.
+    if (exponent <= 3) {
+        mantissa >>= 8 * (3 - exponent);
+        value = mantissa;
+    } else {
+        value = mantissa;
+        value <<= 8 * (exponent - 3);
+    }
+    if (negative)
+        *negative = mantissa != 0 && (bits & 0x00800000);
+    if (overflow)
+        *overflow = mantissa != 0 && (exponent > 34 ||
+                                      (mantissa > 0xff && exponent > 33) ||
+                                      (mantissa > 0xffff && exponent > 32));
+    return value;
+}
+
+uint32_t Uint256::GetCompact() const {
+    unsigned exponent = (Bits() + 7) / 8;
+    uint32_t mantissa = exponent <= 3 ? (uint32_t)(Low64() << 8 * (3 - exponent))
+                                      : (uint32_t)(*this >> 8 * (exponent - 3)).Low64();
+    // The sign bit is taken, shift it into the exponent instead.
+    if (mantissa & 0x00800000) {
+        mantissa >>= 8;
+        exponent++;
+    }
+    return mantissa | exponent << 24;
+}
+
+unsigned Uint256::Bits() const {
+    for (size_t i = limbs.size(); i-- > 0;)
+        if (limbs[i])
+            return 32 * i + 32 - __builtin_clz(limbs[i]);
+    return 0;
+}
+
+Uint256 Uint256::operator~() const {
+    Uint256 result;
+    for (size_t i = 0; i < limbs.size(); i++)
+        result.limbs[i] = ~limbs[i];
+    return result;
+}
+
+Uint256& Uint256::operator+=(const Uint256& other) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < limbs.size(); i++) {
+        carry   += (uint64_t)limbs[i] + other.limbs[i];
+        limbs[i] = (uint32_t)carry;
+        carry  >>= 32;
+    }
+    return *this;
+}
+
+Uint256& Uint256::operator-=(const Uint256& other) {
+    return *this += ++~other; // two's complement
+}
+
+Uint256& Uint256::operator*=(uint32_t factor) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < limbs.size(); i++) {
+        carry   += (uint64_t)limbs[i] * factor;
+        limbs[i] = (uint32_t)carry;
+        carry  >>= 32;
+    }
+    return *this;
+}
+
+// Long division, one bit at a time: only used for block proofs (cached per
+// nBits) and retargeting.
+Uint256& Uint256::operator/=(const Uint256& divisor) {
+    unsigned divisor_bits = divisor.Bits();
+    if (divisor_bits == 0)
+        throw std::domain_error("Uint256: division by zero");
+    unsigned bits = Bits();
+    if (bits < divisor_bits) {
+        *this = 0;
+        return *this;
+    }
+
+    Uint256  remainder = *this, quotient;
+    unsigned shift     = bits - divisor_bits;
+    Uint256  shifted   = divisor << shift;
+    for (;;) {
+        if (remainder >= shifted) {
+            remainder -= shifted;
+            quotient.limbs[shift / 32] |= 1u << (shift % 32);
+        }
+        if (shift-- == 0)
+            break;
+        shifted >>= 1;
+    }
+    *this = quotient;
+    return *this;
+}
+
+Uint256& Uint256::operator<<=(unsigned shift) {
+    Uint256 result;
+    unsigned words = shift / 32, bits = shift % 32;
+    for (size_t i = limbs.size(); i-- > words;) {
+        result.limbs[i] = limbs[i - words] << bits;
+        if (bits && i > words)
+            result.limbs[i] |= limbs[i - words - 1] >> (32 - bits);
+    }
+    *this = result;
+    return *this;
+}
+
+Uint256& Uint256::operator>>=(unsigned shift) {
+    Uint256 result;
+    unsigned words = shift / 32, bits = shift % 32;
+    for (size_t i = 0; i + words < limbs.size(); i++) {
+        result.limbs[i] = limbs[i + words] >> bits;
+        if (bits && i + words + 1 < limbs.size())
+            result.limbs[i] |= limbs[i + words + 1] << (32 - bits);
+    }
+    *this = result;
+    return *this;
+}
+
+std::strong_ordering Uint256::operator<=>(const Uint256& other) const {
+    for (size_t i = limbs.size(); i-- > 0;)
+        if (limbs[i] != other.limbs[i])
+            return limbs[i] <=> other.limbs[i];
+    return std::strong_ordering::equal;
+}
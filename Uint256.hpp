@@ -0,0 +1,55 @@
+#pragma once
+
+#include "hashes.hpp"
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <compare>
+
+// Unsigned 256-bit integer, for proof of work: targets, block proofs and
+// cumulative chain work. Hashes convert as little-endian numbers, the way
+// they are compared to targets.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/arith_uint256.h
+class Uint256 {
+public:
+    constexpr Uint256() = default;
+    constexpr Uint256(uint64_t value): limbs{(uint32_t)value, (uint32_t)(value >> 32)} {}
+    explicit Uint256(const Hash256& hash);
+
+    Hash256 ToHash() const;
+    // Display order hex, as for block hashes.
+    std::string ToString() const;
+
+    // Bitcoin's "compact" floating point encoding of targets (a header's
+    // nBits): 1 byte exponent, 3 bytes mantissa with a sign bit. `negative`
+    // / `overflow` report encodings that aren't a valid target.
+    static Uint256 FromCompact(uint32_t bits, bool* negative = nullptr, bool* overflow = nullptr);
+    uint32_t       GetCompact() const;
+
+    // Position of the highest set bit plus one, 0 for zero.
+    unsigned Bits() const;
+    uint64_t Low64() const { return limbs[0] | (uint64_t)limbs[1] << 32; }
+
+    Uint256  operator~() const;
+    Uint256& operator+=(const Uint256& other);
+    Uint256& operator-=(const Uint256& other);
+    Uint256& operator*=(uint32_t factor);
+    Uint256& operator/=(const Uint256& divisor); // throws std::domain_error on zero
+    Uint256& operator<<=(unsigned shift);
+    Uint256& operator>>=(unsigned shift);
+    Uint256& operator++() { return *this += 1; }
+
+    friend Uint256 operator+(Uint256 a, const Uint256& b)  { return a += b; }
+    friend Uint256 operator-(Uint256 a, const Uint256& b)  { return a -= b; }
+    friend Uint256 operator*(Uint256 a, uint32_t b)        { return a *= b; }
+    friend Uint256 operator/(Uint256 a, const Uint256& b)  { return a /= b; }
+    friend Uint256 operator<<(Uint256 a, unsigned shift)   { return a <<= shift; }
+    friend Uint256 operator>>(Uint256 a, unsigned shift)   { return a >>= shift; }
+
+    bool                 operator==(const Uint256& other) const = default;
+    std::strong_ordering operator<=>(const Uint256& other) const;
+
+private:
+    std::array<uint32_t, 8> limbs{}; // least significant first
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "serialize.hpp"
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// Forward-only cursor filling a caller-provided buffer, the counterpart of
+// Reader. Throws std::runtime_error instead of writing past its end.
+class Writer {
+public:
+    explicit Writer(std::span<uint8_t> out): out(out) {}
+
+    void WriteBytes(std::span<const uint8_t> bytes) {
+        Require(bytes.size());
+        if (!bytes.empty())
+            std::memcpy(out.data() + pos, bytes.data(), bytes.size());
+        pos += bytes.size();
+    }
+
+    // Little-endian integer of sizeof(T) bytes.
+    template <typename T>
+    void Write(T value) { ::Serialize(*this, value); }
+
+    // CompactSize length prefix, see CompactSize.hpp.
+    void WriteCompactSize(uint64_t size) { ::WriteCompactSize(*this, size); }
+
+    size_t Position() const { return pos; }
+
+private:
+    std::span<uint8_t> out;
+    size_t             pos = 0;
+
+    void Require(size_t n) const {
+        if (n > out.size() - pos)
+            throw std::runtime_error("Writer: buffer too small");
+    }
+};
+
+// Appends to a vector, growing it as needed.
+class VectorWriter {
+public:
+    explicit VectorWriter(std::vector<uint8_t>& out): out(out) {}
+
+    void WriteBytes(std::span<const uint8_t> bytes) {
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+private:
+    std::vector<uint8_t>& out;
+};
+
+// Writes nothing, only counts (see GetSerializeSize).
+class SizeComputer {
+public:
+    void   WriteBytes(std::span<const uint8_t> bytes) { size += bytes.size(); }
+    size_t Size() const { return size; }
+
+private:
+    size_t size = 0;
+};
+
+// Serialized size of `object`, a constant for fixed-size types.
+template <typename T>
+size_t GetSerializeSize(const T& object) {
+    if constexpr (FIXED_SIZE<T> != 0)
+        return FIXED_SIZE<T>;
+    SizeComputer counter;
+    ::Serialize(counter, object);
+    return counter.Size();
+}
@@ -0,0 +1,35 @@
+#include "bench.hpp"
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+
+// Every heap allocation of the bench binary goes through these, for the
+// allocations per transaction of replay's stages. A relaxed increment, noise
+// next to malloc itself. In a translation unit of their own, so that the
+// compiler never sees a replaced new and delete inlined next to each other.
+static std::atomic<uint64_t> allocations = 0;
+
+uint64_t AllocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t alignment = (size_t)align;
+    if (void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept                          { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept                  { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept        { std::free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
@@ -0,0 +1,110 @@
+#include "bench.hpp"
+
+#include "Block.hpp"
+#include "merkle.hpp"
+
+#include <fstream>
+#include <cctype>
+#include <iterator>
+#include <algorithm>
+#include <memory_resource>
+
+// Raw block, binary or hex (as from `bitcoin-cli getblock <hash> 0`).
+std::vector<uint8_t> LoadBlock(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("can't open " + path);
+    std::string content((std::istreambuf_iterator<char>(file)), {});
+    std::string hex;
+    for (char c: content)
+        if (!std::isspace((unsigned char)c))
+            hex += c;
+    if (!hex.empty() && std::all_of(hex.begin(), hex.end(),
+                                    [](char c) { return std::isxdigit((unsigned char)c); }))
+        return hex2bytes(hex);
+    return std::vector<uint8_t>(content.begin(), content.end());
+}
+
+// ~750 kB worth of 2-in/2-out transactions, one legacy and one segwit input
+// each, after a coinbase. Structurally valid (merkle root, CheckBlock) but
+// the header isn't mined.
+std::vector<uint8_t> MakeBlock() {
+    const uint32_t n_txs = 2000;
+    Block block(BlockHeader(0x20000000, Hash256{}, Hash256{}, 1600000000, 0x207fffff, 0), {});
+
+    std::pmr::vector<TxIn>  coinbase_in;
+    std::pmr::vector<TxOut> coinbase_out;
+    coinbase_in.emplace_back(OutPoint{Hash256{}, 0xffffffff}, Script() << 650000 << OP_0, 0xffffffff);
+    coinbase_out.emplace_back(625000000, Script() << OP_0 << std::vector<uint8_t>(20, 0xcb));
+    block.AddTx(Tx(2, std::move(coinbase_in), std::move(coinbase_out), 0));
+
+    for (uint32_t i = 0; i < n_txs; i++) {
+        std::pmr::vector<TxIn>  inputs;
+        std::pmr::vector<TxOut> outputs;
+        OutPoint prevout;
+        prevout.txid.fill((uint8_t)i);
+        prevout.n = i;
+        inputs.emplace_back(prevout, Script() << std::vector<uint8_t>(72, (uint8_t)i)
+                                              << std::vector<uint8_t>(33, 0x02), 0xffffffff);
+        prevout.n++;
+        inputs.emplace_back(prevout, Script(), 0xffffffff,
+            Witness{std::pmr::vector<uint8_t>(72, (uint8_t)i), std::pmr::vector<uint8_t>(33, 0x03)});
+        outputs.emplace_back(1000 + i, Script() << OP_DUP << OP_HASH160
+                                                << std::vector<uint8_t>(20, (uint8_t)i)
+                                                << OP_EQUALVERIFY << OP_CHECKSIG);
+        outputs.emplace_back(2000 + i, Script() << OP_0 << std::vector<uint8_t>(20, (uint8_t)i));
+        block.AddTx(Tx(2, std::move(inputs), std::move(outputs), 0));
+    }
+
+    BlockHeader header = block.GetHeader();
+    block.SetHeader(header.SetMerkleRoot(BlockMerkleRoot(block)));
+    return block.Serialize();
+}
+
+int BenchBlockArena(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 100;
+    auto   block      = argc > 2 ? LoadBlock(argv[2]) : MakeBlock();
+
+    auto report = [&](const char* name, double seconds) {
+        std::cout << name << ": " << seconds / iterations * 1e3 << " ms/block, "
+                  << (size_t)(iterations * block.size() / seconds / 1e6) << " MB/s" << std::endl;
+        return seconds;
+    };
+
+    Reader header(block);
+    header.ReadBytes(80);
+    size_t n_txs = header.ReadCompactSize();
+    std::cout << "block       : " << block.size() << " bytes, " << n_txs << " txs" << std::endl;
+
+    // Parse every tx, then drop them all, as a block validation pass would.
+    size_t check = 0;
+    Timer heap_timer;
+    for (size_t i = 0; i < iterations; i++) {
+        Reader reader(header.Rest());
+        std::vector<Tx> txs;
+        txs.reserve(n_txs);
+        for (size_t n = 0; n < n_txs; n++)
+            txs.emplace_back(reader);
+        check += txs.back().GetOutputs().size();
+    }
+    double heap = report("heap        ", heap_timer.Seconds());
+
+    // Same into an arena over one reused buffer, it only falls back to the
+    // heap if the buffer is too small. Releasing it is O(1), the Tx
+    // destructors still run but free nothing.
+    std::vector<std::byte> buffer(4 * block.size());
+    Timer arena_timer;
+    for (size_t i = 0; i < iterations; i++) {
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+        Reader reader(header.Rest());
+        std::pmr::vector<Tx> txs(&arena);
+        txs.reserve(n_txs);
+        for (size_t n = 0; n < n_txs; n++)
+            txs.emplace_back(reader, &arena);
+        check += txs.back().GetOutputs().size();
+    }
+    double arena = report("arena       ", arena_timer.Seconds());
+    std::cout << "speedup     : " << heap / arena << "x" << std::endl;
+
+    return check == 0;
+}
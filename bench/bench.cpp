@@ -0,0 +1,42 @@
+// Benchmarks and consistency checks for the library.
+//
+// Build from the repository root, e.g.:
+//   g++ -std=c++20 -O2 -I. bench/*.cpp Script*.cpp Tx*.cpp Block*.cpp OutPoint.cpp CompactSize.cpp Reader.cpp HashWriter.cpp SocketWriter.cpp ThreadPool.cpp HeaderChain.cpp Miner.cpp ChainParams.cpp Uint256.cpp sha256.cpp txformat.cpp merkle.cpp pow.cpp validation.cpp hashes.cpp hex.cpp utils.cpp -lcrypto -pthread -o btc-bench
+
+#include "bench.hpp"
+
+#include <iostream>
+#include <string>
+#include <map>
+
+using Subcommand = int (*)(int argc, char** argv);
+
+static const std::map<std::string, std::pair<Subcommand, const char*>> subcommands = {
+    {"blk-files",    {BenchBlockFiles,  "<blocks dir> [index file] [blocks]  blk*.dat index, then parsing in height order"}},
+    {"block",        {BenchBlock,       "[iterations] [block files...]  block parsing and CheckBlock() throughput"}},
+    {"block-arena",  {BenchBlockArena,  "[iterations] [block file]  block parsing, heap vs per-block arena"}},
+    {"block-parallel", {BenchBlockParallel, "[iterations] [threads] [block file]  sequential vs two-phase parallel block parsing"}},
+    {"headers",      {BenchHeaders,     "[count] [threads] [headers file]  HeaderChain ingestion (hashing, PoW, retargets, best chain)"}},
+    {"hex",          {BenchHex,         "[iterations]  scalar / SSSE3 / AVX2 hex codecs"}},
+    {"interpreter",  {BenchInterpreter, "[iterations]  reference vs threaded interpreter"}},
+    {"mine",         {BenchMine,        "[threads] [seconds] [blocks]  nonce scanning and Miner hashrate, regtest block production"}},
+    {"replay",       {BenchReplay,      "<blocks dir> [threads] [blocks]  parse, hash, merkle, utxo and script stages over a chain of blocks"}},
+    {"script-tests", {BenchScriptTests, "<script_tests.json> [iterations] [-v]  Bitcoin Core script vectors"}},
+    {"tx-parse",     {BenchTxParse,     "[iterations]  Tx / TxView parsing, serialization and JSON formatting"}},
+    {"tx-tests",     {BenchTxTests,     "<tx_valid.json> <tx_invalid.json> [-v]  Bitcoin Core tx vectors"}},
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2 || !subcommands.count(argv[1])) {
+        std::cerr << "usage: " << argv[0] << " <subcommand> [args...]" << std::endl;
+        for (auto& [name, cmd]: subcommands)
+            std::cerr << "    " << name << " " << cmd.second << std::endl;
+        return 1;
+    }
+    try {
+        return subcommands.at(argv[1]).first(argc - 1, argv + 1);
+    } catch (const std::exception& e) {
+        std::cerr << argv[1] << ": " << e.what() << std::endl;
+        return 1;
+    }
+}
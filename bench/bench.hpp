@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Benchmark / consistency-check subcommands, see bench.cpp.
+int BenchInterpreter(int argc, char** argv);
+int BenchScriptTests(int argc, char** argv);
+int BenchTxTests(int argc, char** argv);
+int BenchTxParse(int argc, char** argv);
+int BenchBlockArena(int argc, char** argv);
+int BenchHex(int argc, char** argv);
+int BenchBlock(int argc, char** argv);
+int BenchBlockParallel(int argc, char** argv);
+int BenchBlockFiles(int argc, char** argv);
+int BenchHeaders(int argc, char** argv);
+int BenchMine(int argc, char** argv);
+int BenchReplay(int argc, char** argv);
+
+// Raw block file, binary or hex / synthetic ~750 kB block (arena.cpp).
+std::vector<uint8_t> LoadBlock(const std::string& path);
+std::vector<uint8_t> MakeBlock();
+
+// Heap allocations of the whole binary so far, global operator new being
+// replaced (allocs.cpp).
+uint64_t AllocationCount();
+
+// Wall clock stopwatch.
+class Timer {
+public:
+    Timer(): start(std::chrono::steady_clock::now()) {}
+
+    double Seconds() const {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,126 @@
+#include "bench.hpp"
+
+#include "Block.hpp"
+#include "validation.hpp"
+#include "TxView.hpp"
+
+#include <memory_resource>
+
+/* Block throughput: parse only, then parse + CheckBlock (txids, merkle root,
+   proof of work, every transaction's structure and sigops), over raw block
+   files (see LoadBlock) or the synthetic block. Each block goes into an
+   arena reused from one iteration to the next, as a sync loop would do. The
+   synthetic block isn't mined so its proof of work isn't checked. */
+int BenchBlock(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 100;
+    bool   synthetic  = argc <= 2;
+
+    std::vector<std::vector<uint8_t>> blocks;
+    if (synthetic)
+        blocks.push_back(MakeBlock());
+    for (int i = 2; i < argc; i++)
+        blocks.push_back(LoadBlock(argv[i]));
+
+    // Round trip and sanity check first, so the timings below are known to
+    // be over valid blocks.
+    size_t bytes = 0, n_txs = 0, largest = 0;
+    for (auto& serialized: blocks) {
+        Block block(serialized);
+        if (block.Serialize() != serialized)
+            throw std::runtime_error("round trip mismatch");
+        CheckBlock(block, !synthetic);
+        bytes  += serialized.size();
+        n_txs  += block.GetTxs().size();
+        largest = std::max(largest, serialized.size());
+        if (blocks.size() == 1)
+            std::cout << "block       : " << serialized.size() << " bytes, " << block.GetTxs().size()
+                      << " txs, weight " << block.GetWeight() << ", hash "
+                      << toDisplayHex(block.GetHash()) << std::endl;
+    }
+    if (blocks.size() > 1)
+        std::cout << "blocks      : " << blocks.size() << ", " << bytes << " bytes, "
+                  << n_txs << " txs" << std::endl;
+
+    auto report = [&](const char* name, double seconds) {
+        std::cout << name << ": " << (size_t)(iterations * bytes / seconds / 1e6) << " MB/s, "
+                  << (size_t)(iterations * n_txs / seconds) << " tx/s" << std::endl;
+    };
+
+    std::vector<std::byte> buffer(4 * largest);
+    size_t check = 0;
+
+    Timer parse_timer;
+    for (size_t i = 0; i < iterations; i++)
+        for (auto& serialized: blocks) {
+            std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+            Block block(serialized, &arena);
+            check += block.GetTxs().size();
+        }
+    report("parse       ", parse_timer.Seconds());
+
+    Timer check_timer;
+    for (size_t i = 0; i < iterations; i++)
+        for (auto& serialized: blocks) {
+            std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+            Block block(serialized, &arena);
+            CheckBlock(block, !synthetic);
+            check += block.GetTxs().size();
+        }
+    report("parse+check ", check_timer.Seconds());
+
+    return check == 0;
+}
+
+/* Sequential parse + txids/wtxids vs the two-phase parallel Block
+   constructor, both on the default (thread-safe) heap, and the first phase
+   alone: the part left sequential. */
+int BenchBlockParallel(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 100;
+    size_t threads    = argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+    auto   serialized = argc > 3 ? LoadBlock(argv[3]) : MakeBlock();
+    ThreadPool pool(threads);
+
+    auto report = [&](const char* name, double seconds) {
+        std::cout << name << ": " << seconds / iterations * 1e3 << " ms/block, "
+                  << (size_t)(iterations * serialized.size() / seconds / 1e6) << " MB/s" << std::endl;
+        return seconds;
+    };
+
+    // Both must agree before timing anything.
+    Block sequential(serialized), parallel(serialized, pool);
+    if (sequential.GetTxs().size() != parallel.GetTxs().size())
+        throw std::runtime_error("parallel parse: transaction count mismatch");
+    for (size_t i = 0; i < sequential.GetTxs().size(); i++)
+        if (sequential.GetTxs()[i].GetWTxId() != parallel.GetTxs()[i].GetWTxId())
+            throw std::runtime_error("parallel parse: wtxid mismatch");
+    std::cout << "block       : " << serialized.size() << " bytes, " << sequential.GetTxs().size()
+              << " txs, " << pool.Size() << " threads" << std::endl;
+
+    size_t check = 0;
+    Timer sequential_timer;
+    for (size_t i = 0; i < iterations; i++) {
+        Block block(serialized);
+        for (auto& tx: block.GetTxs())
+            check += tx.GetTxId()[0] + tx.GetWTxId()[0];
+    }
+    double seconds = report("sequential  ", sequential_timer.Seconds());
+
+    Timer skip_timer;
+    for (size_t i = 0; i < iterations; i++) {
+        Reader reader(serialized);
+        reader.ReadBytes(FIXED_SIZE<BlockHeader>);
+        for (uint64_t n = reader.ReadCompactSize(); n > 0; n--)
+            check += TxView::Skip(reader).size();
+    }
+    report("phase 1     ", skip_timer.Seconds());
+
+    Timer parallel_timer;
+    for (size_t i = 0; i < iterations; i++) {
+        Block block(serialized, pool);
+        check += block.GetTxs().size();
+    }
+    double parallel_seconds = report("two-phase   ", parallel_timer.Seconds());
+    std::cout << "speedup     : " << seconds / parallel_seconds << "x" << std::endl;
+
+    return check == 0;
+}
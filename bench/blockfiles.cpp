@@ -0,0 +1,44 @@
+#include "bench.hpp"
+
+#include "BlockFiles.hpp"
+#include "Block.hpp"
+
+#include <memory_resource>
+
+/* Index a blocks/ directory (loading / updating `index file` if given), then
+   parse the best chain's blocks in height order, up to `blocks` of them,
+   straight from the mappings. Run it twice to see the index load instead of
+   the scan. */
+int BenchBlockFiles(int argc, char** argv) {
+    if (argc < 2)
+        throw std::runtime_error("usage: blk-files <blocks dir> [index file] [blocks]");
+    std::string index_path = argc > 2 ? argv[2] : "";
+    size_t      max_blocks = argc > 3 ? std::stoul(argv[3]) : SIZE_MAX;
+
+    Timer index_timer;
+    BlockFiles files(argv[1], index_path);
+    double index_seconds = index_timer.Seconds();
+    std::cout << "index       : " << files.FileCount() << " files, " << files.BlockCount()
+              << " blocks, height " << files.GetHeight() << ", "
+              << index_seconds * 1e3 << " ms" << std::endl;
+
+    size_t n_blocks = std::min<size_t>(files.GetHeight() + 1, max_blocks);
+    size_t bytes = 0, n_txs = 0;
+    std::vector<std::byte> buffer(16 << 20);
+    files.Advise(BlockFiles::Access::Sequential);
+    Timer timer;
+    for (size_t height = 0; height < n_blocks; height++) {
+        auto serialized = files.GetBlock(height);
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+        Block block(serialized, &arena);
+        bytes += serialized.size();
+        n_txs += block.GetTxs().size();
+    }
+    double seconds = timer.Seconds();
+    std::cout << "chain       : " << n_blocks << " blocks, " << n_txs << " txs, "
+              << bytes << " bytes" << std::endl;
+    std::cout << "parse       : " << (size_t)(bytes / seconds / 1e6) << " MB/s, "
+              << (size_t)(n_blocks / seconds) << " blocks/s, "
+              << (size_t)(n_txs / seconds) << " tx/s" << std::endl;
+    return 0;
+}
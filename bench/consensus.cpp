@@ -0,0 +1,271 @@
+#include "bench.hpp"
+
+#include "Script.hpp"
+#include "Tx.hpp"
+#include "validation.hpp"
+#include "json.hpp" // nlohmann
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <map>
+
+using json = nlohmann::json;
+
+// Bitcoin Core's consensus test vectors (src/test/data/script_tests.json,
+// tx_valid.json, tx_invalid.json), read from local copies.
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/test/script_tests.cpp#L47
+static const std::map<std::string, ScriptError> ERROR_NAMES = {
+    {"OK",                                      SCRIPT_ERR_OK},
+    {"UNKNOWN_ERROR",                           SCRIPT_ERR_UNKNOWN_ERROR},
+    {"EVAL_FALSE",                              SCRIPT_ERR_EVAL_FALSE},
+    {"OP_RETURN",                               SCRIPT_ERR_OP_RETURN},
+    {"SCRIPT_SIZE",                             SCRIPT_ERR_SCRIPT_SIZE},
+    {"PUSH_SIZE",                               SCRIPT_ERR_PUSH_SIZE},
+    {"OP_COUNT",                                SCRIPT_ERR_OP_COUNT},
+    {"STACK_SIZE",                              SCRIPT_ERR_STACK_SIZE},
+    {"SIG_COUNT",                               SCRIPT_ERR_SIG_COUNT},
+    {"PUBKEY_COUNT",                            SCRIPT_ERR_PUBKEY_COUNT},
+    {"VERIFY",                                  SCRIPT_ERR_VERIFY},
+    {"EQUALVERIFY",                             SCRIPT_ERR_EQUALVERIFY},
+    {"CHECKMULTISIGVERIFY",                     SCRIPT_ERR_CHECKMULTISIGVERIFY},
+    {"CHECKSIGVERIFY",                          SCRIPT_ERR_CHECKSIGVERIFY},
+    {"NUMEQUALVERIFY",                          SCRIPT_ERR_NUMEQUALVERIFY},
+    {"BAD_OPCODE",                              SCRIPT_ERR_BAD_OPCODE},
+    {"DISABLED_OPCODE",                         SCRIPT_ERR_DISABLED_OPCODE},
+    {"INVALID_STACK_OPERATION",                 SCRIPT_ERR_INVALID_STACK_OPERATION},
+    {"INVALID_ALTSTACK_OPERATION",              SCRIPT_ERR_INVALID_ALTSTACK_OPERATION},
+    {"UNBALANCED_CONDITIONAL",                  SCRIPT_ERR_UNBALANCED_CONDITIONAL},
+    {"NEGATIVE_LOCKTIME",                       SCRIPT_ERR_NEGATIVE_LOCKTIME},
+    {"UNSATISFIED_LOCKTIME",                    SCRIPT_ERR_UNSATISFIED_LOCKTIME},
+    {"SIG_HASHTYPE",                            SCRIPT_ERR_SIG_HASHTYPE},
+    {"SIG_DER",                                 SCRIPT_ERR_SIG_DER},
+    {"MINIMALDATA",                             SCRIPT_ERR_MINIMALDATA},
+    {"SIG_PUSHONLY",                            SCRIPT_ERR_SIG_PUSHONLY},
+    {"SIG_HIGH_S",                              SCRIPT_ERR_SIG_HIGH_S},
+    {"SIG_NULLDUMMY",                           SCRIPT_ERR_SIG_NULLDUMMY},
+    {"PUBKEYTYPE",                              SCRIPT_ERR_PUBKEYTYPE},
+    {"CLEANSTACK",                              SCRIPT_ERR_CLEANSTACK},
+    {"MINIMALIF",                               SCRIPT_ERR_MINIMALIF},
+    {"NULLFAIL",                                SCRIPT_ERR_SIG_NULLFAIL},
+    {"DISCOURAGE_UPGRADABLE_NOPS",              SCRIPT_ERR_DISCOURAGE_UPGRADABLE_NOPS},
+    {"DISCOURAGE_UPGRADABLE_WITNESS_PROGRAM",   SCRIPT_ERR_DISCOURAGE_UPGRADABLE_WITNESS_PROGRAM},
+    {"WITNESS_PROGRAM_WRONG_LENGTH",            SCRIPT_ERR_WITNESS_PROGRAM_WRONG_LENGTH},
+    {"WITNESS_PROGRAM_WITNESS_EMPTY",           SCRIPT_ERR_WITNESS_PROGRAM_WITNESS_EMPTY},
+    {"WITNESS_PROGRAM_MISMATCH",                SCRIPT_ERR_WITNESS_PROGRAM_MISMATCH},
+    {"WITNESS_MALLEATED",                       SCRIPT_ERR_WITNESS_MALLEATED},
+    {"WITNESS_MALLEATED_P2SH",                  SCRIPT_ERR_WITNESS_MALLEATED_P2SH},
+    {"WITNESS_UNEXPECTED",                      SCRIPT_ERR_WITNESS_UNEXPECTED},
+    {"WITNESS_PUBKEYTYPE",                      SCRIPT_ERR_WITNESS_PUBKEYTYPE},
+    {"OP_CODESEPARATOR",                        SCRIPT_ERR_OP_CODESEPARATOR},
+    {"SIG_FINDANDDELETE",                       SCRIPT_ERR_SIG_FINDANDDELETE},
+};
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/test/transaction_tests.cpp#L40
+static const std::map<std::string, uint32_t> FLAG_NAMES = {
+    {"NONE",                                    SCRIPT_VERIFY_NONE},
+    {"P2SH",                                    SCRIPT_VERIFY_P2SH},
+    {"STRICTENC",                               SCRIPT_VERIFY_STRICTENC},
+    {"DERSIG",                                  SCRIPT_VERIFY_DERSIG},
+    {"LOW_S",                                   SCRIPT_VERIFY_LOW_S},
+    {"SIGPUSHONLY",                             SCRIPT_VERIFY_SIGPUSHONLY},
+    {"MINIMALDATA",                             SCRIPT_VERIFY_MINIMALDATA},
+    {"NULLDUMMY",                               SCRIPT_VERIFY_NULLDUMMY},
+    {"DISCOURAGE_UPGRADABLE_NOPS",              SCRIPT_VERIFY_DISCOURAGE_UPGRADABLE_NOPS},
+    {"CLEANSTACK",                              SCRIPT_VERIFY_CLEANSTACK},
+    {"MINIMALIF",                               SCRIPT_VERIFY_MINIMALIF},
+    {"NULLFAIL",                                SCRIPT_VERIFY_NULLFAIL},
+    {"CHECKLOCKTIMEVERIFY",                     SCRIPT_VERIFY_CHECKLOCKTIMEVERIFY},
+    {"CHECKSEQUENCEVERIFY",                     SCRIPT_VERIFY_CHECKSEQUENCEVERIFY},
+    {"WITNESS",                                 SCRIPT_VERIFY_WITNESS},
+    {"DISCOURAGE_UPGRADABLE_WITNESS_PROGRAM",   SCRIPT_VERIFY_DISCOURAGE_UPGRADABLE_WITNESS_PROGRAM},
+    {"WITNESS_PUBKEYTYPE",                      SCRIPT_VERIFY_WITNESS_PUBKEYTYPE},
+    {"CONST_SCRIPTCODE",                        SCRIPT_VERIFY_CONST_SCRIPTCODE},
+    {"TAPROOT",                                 SCRIPT_VERIFY_TAPROOT},
+    {"BADTX",                                   SCRIPT_VERIFY_NONE}, // fails CheckTransaction(), run on every tx
+};
+
+static std::string ErrorName(ScriptError error) {
+    for (auto& [name, value]: ERROR_NAMES)
+        if (value == error)
+            return name;
+    return "ERROR_" + std::to_string((int)error);
+}
+
+// "P2SH,STRICTENC" -> bits
+static uint32_t ParseFlags(const std::string& names) {
+    uint32_t flags = SCRIPT_VERIFY_NONE;
+    std::istringstream list(names);
+    std::string name;
+    while (std::getline(list, name, ','))
+        if (!name.empty())
+            flags |= FLAG_NAMES.at(name);
+    return flags;
+}
+
+static json LoadJson(const std::string& path) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("cannot open " + path);
+    return json::parse(file);
+}
+
+struct ScriptVector {
+    size_t      line;       // index in the json array
+    std::string text;       // as found in the file, for reports
+    Script      script_sig;
+    Script      script_pubkey;
+    uint32_t    flags;
+    ScriptError expected;
+};
+
+static const char* EngineName(ScriptEngine engine) {
+    return engine == ScriptEngine::Threaded ? "threaded " : "reference";
+}
+
+/* script_tests.json entries are either comments (a single string) or
+   [[witness..., amount]?, scriptSig, scriptPubKey, flags, expected, comment?]
+   Entries with a witness are skipped, there is no witness support yet. */
+int BenchScriptTests(int argc, char** argv) {
+    if (argc < 2)
+        throw std::runtime_error("usage: script-tests <script_tests.json> [iterations] [-v]");
+    size_t iterations = (argc > 2 && argv[2][0] != '-') ? std::stoul(argv[2]) : 100;
+    bool   verbose    = std::string(argv[argc-1]) == "-v";
+
+    std::vector<ScriptVector> vectors;
+    size_t skipped = 0, unparsed = 0;
+    auto tests = LoadJson(argv[1]);
+    for (size_t i = 0; i < tests.size(); i++) {
+        auto& test = tests[i];
+        if (test.size() < 4)
+            continue; // comment
+        if (test[0].is_array()) {
+            skipped++;
+            continue;
+        }
+        try {
+            vectors.push_back({i, test.dump(),
+                               Script::FromAsm(test[0].get<std::string>()),
+                               Script::FromAsm(test[1].get<std::string>()),
+                               ParseFlags(test[2].get<std::string>()),
+                               ERROR_NAMES.at(test[3].get<std::string>())});
+        } catch (const std::exception& e) {
+            unparsed++;
+            std::cout << "UNPARSED #" << i << " " << test.dump() << ": " << e.what() << std::endl;
+        }
+    }
+
+    // Per-vector results, both engines must agree with the expected error.
+    size_t failed = 0;
+    for (auto& v: vectors) {
+        bool pass = true;
+        std::string report;
+        for (auto engine: {ScriptEngine::Reference, ScriptEngine::Threaded}) {
+            auto error = Script::Verify(v.script_sig, v.script_pubkey, v.flags, engine);
+            if (error != v.expected) {
+                pass = false;
+                report += std::string(" ") + EngineName(engine) + "=" + ErrorName(error);
+            }
+        }
+        failed += !pass;
+        if (!pass || verbose)
+            std::cout << (pass ? "PASS #" : "FAIL #") << v.line << " " << v.text << report << std::endl;
+    }
+    std::cout << "vectors     : " << vectors.size() << " run, "
+              << vectors.size() - failed << " pass, " << failed << " fail, "
+              << skipped << " skipped (witness), " << unparsed << " unparsed" << std::endl;
+
+    // Throughput over the whole set, each vector being a scriptSig/scriptPubKey pair.
+    for (auto engine: {ScriptEngine::Reference, ScriptEngine::Threaded}) {
+        Timer timer;
+        for (size_t i = 0; i < iterations; i++)
+            for (auto& v: vectors)
+                Script::Verify(v.script_sig, v.script_pubkey, v.flags, engine);
+        double seconds = timer.Seconds();
+        std::cout << EngineName(engine) << "   : "
+                  << (size_t)(iterations * vectors.size() / seconds) << " vectors/s, "
+                  << (size_t)(2 * iterations * vectors.size() / seconds) << " scripts/s" << std::endl;
+    }
+    return failed || unparsed ? 1 : 0;
+}
+
+/* tx_valid.json / tx_invalid.json entries are either comments or
+   [[[prevout hash, prevout index, prevout scriptPubKey, amount?]...], tx hex, flags]
+   For tx_valid the flags are the ones to exclude from the full set, for
+   tx_invalid the ones to apply (Bitcoin Core >= 0.21 layout). A valid tx
+   must pass CheckTransaction() and every input's scripts, an invalid one
+   must fail either (or not parse at all). */
+static size_t RunTxVectors(const std::string& path, bool valid, bool verbose,
+                           size_t& run) {
+    uint32_t all_flags = 0;
+    for (auto& [name, flag]: FLAG_NAMES)
+        all_flags |= flag;
+
+    size_t failed = 0;
+    auto tests = LoadJson(path);
+    for (size_t i = 0; i < tests.size(); i++) {
+        auto& test = tests[i];
+        if (test.size() < 3 || !test[0].is_array())
+            continue; // comment
+        run++;
+
+        std::string outcome;
+        bool accepted = true;
+        try {
+            uint32_t flags = ParseFlags(test[2].get<std::string>());
+            if (valid)
+                flags = all_flags & ~flags;
+
+            // "txid (display order):index" -> scriptPubKey
+            std::map<std::string, Script> prevouts;
+            for (auto& prevout: test[0])
+                prevouts[prevout[0].get<std::string>() + ":" +
+                         std::to_string((uint32_t)prevout[1].get<int64_t>())] =
+                    Script::FromAsm(prevout[2].get<std::string>());
+
+            Tx tx(hex2bytes(test[1].get<std::string>()));
+            CheckTransaction(tx);
+
+            auto& inputs = tx.GetInputs();
+            for (size_t n = 0; n < inputs.size() && accepted; n++) {
+                auto key = inputs[n].GetPrevOut().ToString();
+                if (!prevouts.count(key)) {
+                    accepted = false;
+                    outcome  = "missing prevout " + key;
+                    break;
+                }
+                auto error = Script::Verify(inputs[n].GetScript(), prevouts.at(key), flags);
+                if (error != SCRIPT_ERR_OK) {
+                    accepted = false;
+                    outcome  = "input " + std::to_string(n) + ": " + ErrorName(error);
+                }
+            }
+        } catch (const std::exception& e) {
+            accepted = false;
+            outcome  = e.what();
+        }
+
+        bool pass = accepted == valid;
+        failed += !pass;
+        if (!pass || verbose)
+            std::cout << (pass ? "PASS #" : "FAIL #") << i << " " << test.dump()
+                      << (outcome.empty() ? "" : " (" + outcome + ")") << std::endl;
+    }
+    return failed;
+}
+
+int BenchTxTests(int argc, char** argv) {
+    if (argc < 3)
+        throw std::runtime_error("usage: tx-tests <tx_valid.json> <tx_invalid.json> [-v]");
+    bool verbose = std::string(argv[argc-1]) == "-v";
+
+    size_t run_valid = 0, run_invalid = 0;
+    size_t failed_valid   = RunTxVectors(argv[1], true,  verbose, run_valid);
+    size_t failed_invalid = RunTxVectors(argv[2], false, verbose, run_invalid);
+    std::cout << "tx_valid    : " << run_valid << " run, " << run_valid - failed_valid
+              << " pass, " << failed_valid << " fail" << std::endl
+              << "tx_invalid  : " << run_invalid << " run, " << run_invalid - failed_invalid
+              << " pass, " << failed_invalid << " fail" << std::endl;
+    return failed_valid || failed_invalid ? 1 : 0;
+}
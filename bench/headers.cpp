@@ -0,0 +1,97 @@
+#include "bench.hpp"
+
+#include "HeaderChain.hpp"
+#include "ThreadPool.hpp"
+#include "sha256.hpp"
+#include "endian.hpp"
+#include "pow.hpp"
+#include "utils.hpp"
+
+#include <iostream>
+
+/* `count` headers on a regtest-like network with one block a minute (so that
+   900k of them don't end up in the future), mined: each header's hash is
+   below the target its nBits must have. Consecutive 80-byte headers. */
+static std::vector<uint8_t> MakeHeaders(const ChainParams& params, size_t count) {
+    std::vector<uint8_t> headers(count * 80);
+    Hash256  prev     = params.genesis.GetHash();
+    uint32_t bits     = params.genesis.GetBits();
+    uint32_t time     = params.genesis.GetTime();
+    uint32_t period   = time; // of the current period's first block
+    int64_t  interval = params.DifficultyAdjustmentInterval();
+
+    for (size_t i = 0; i < count; i++) {
+        uint64_t height = i + 1;
+        time += params.pow_target_spacing;
+        if (height % interval == 0) {
+            bits   = CalculateNextWorkRequired(bits, time - params.pow_target_spacing, period, params);
+            period = time;
+        }
+
+        uint8_t* header = headers.data() + 80*i;
+        WriteLE32(header, 4);
+        std::copy(prev.begin(), prev.end(), header + 4);
+        WriteLE64(header + 36, height); // merkle root, anything unique
+        WriteLE32(header + 68, time);
+        WriteLE32(header + 72, bits);
+        for (uint32_t nonce = 0;; nonce++) {
+            WriteLE32(header + 76, nonce);
+            Sha256::Hash80(header, 1, &prev);
+            if (CheckProofOfWork(prev, bits, params))
+                break;
+        }
+    }
+    return headers;
+}
+
+/* Header chain ingestion: hashing and proof of work, then the contextual
+   checks and best chain tracking, single-threaded and over a pool. The
+   headers are a file of consecutive 80-byte mainnet headers (binary or hex,
+   see LoadBlock), or `count` synthetic ones. */
+int BenchHeaders(int argc, char** argv) {
+    size_t count   = argc > 1 ? std::stoul(argv[1]) : 900000;
+    size_t threads = argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+
+    ChainParams synthetic = ChainParams::Regtest();
+    synthetic.pow_allow_min_difficulty_blocks = false;
+    synthetic.pow_target_spacing              = 60;
+    synthetic.pow_target_timespan             = 2016 * 60;
+    const ChainParams& params = argc > 3 ? ChainParams::Main() : synthetic;
+
+    std::vector<uint8_t> headers;
+    if (argc > 3) {
+        headers = LoadBlock(argv[3]);
+        headers.resize(std::min(headers.size() / 80, count) * 80);
+    } else {
+        Timer timer;
+        headers = MakeHeaders(synthetic, count);
+        std::cout << "mining      : " << timer.Seconds() * 1e3 << " ms" << std::endl;
+    }
+    count = headers.size() / 80;
+
+    static const char* ISA_NAMES[] = {"scalar", "avx2", "sha-ni"};
+    std::vector<Hash256> hashes(count);
+    Timer hash_timer;
+    Sha256::Hash80(headers.data(), count, hashes.data());
+    double hash_seconds = hash_timer.Seconds();
+    std::cout << "hash        : " << count << " headers, " << ISA_NAMES[(int)Sha256::Detect()] << ", "
+              << hash_seconds * 1e3 << " ms, " << (size_t)(count / hash_seconds) << " headers/s" << std::endl;
+
+    auto ingest = [&](const char* name, ThreadPool* pool) {
+        HeaderChain chain(params);
+        Timer timer;
+        size_t added = chain.AddHeaders(std::span<const uint8_t>(headers), pool);
+        double seconds = timer.Seconds();
+        if (added != count || chain.GetHeight() != count || chain.GetHash(count) != hashes.back())
+            throw std::runtime_error("unexpected chain");
+        std::cout << name << ": " << seconds * 1e3 << " ms, " << (size_t)(count / seconds)
+                  << " headers/s, height " << chain.GetHeight() << ", tip "
+                  << toDisplayHex(chain.GetHash(chain.GetHeight())) << ", work "
+                  << chain.GetChainWork().ToString() << std::endl;
+    };
+    ingest("ingest      ", nullptr);
+    ThreadPool pool(threads);
+    std::cout << "threads     : " << pool.Size() << std::endl;
+    ingest("ingest pool ", &pool);
+    return 0;
+}
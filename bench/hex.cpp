@@ -0,0 +1,65 @@
+#include "bench.hpp"
+
+#include "hex.hpp"
+
+#include <random>
+#include <vector>
+#include <iostream>
+
+int BenchHex(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 200;
+
+    // 1 MB of random bytes, odd-sized so the scalar tails get exercised.
+    std::vector<uint8_t> bytes((1 << 20) + 7);
+    std::mt19937 rng(42);
+    for (auto& b: bytes)
+        b = (uint8_t)rng();
+
+    std::string reference(bytes.size() * 2, '\0');
+    Hex::Encode(bytes, reference.data(), Hex::Isa::Scalar);
+
+    // Uppercase copy, decoding has to accept both.
+    std::string upper = reference;
+    for (auto& c: upper)
+        c = (char)std::toupper((unsigned char)c);
+
+    const std::pair<Hex::Isa, const char*> codecs[] = {
+        {Hex::Isa::Scalar, "scalar"}, {Hex::Isa::SSSE3, "ssse3 "}, {Hex::Isa::AVX2, "avx2  "}};
+
+    size_t failed = 0;
+    for (auto& [isa, name]: codecs) {
+        if (isa > Hex::Detect())
+            continue;
+
+        std::string hex(reference.size(), '\0');
+        Timer encode_timer;
+        for (size_t i = 0; i < iterations; i++)
+            Hex::Encode(bytes, hex.data(), isa);
+        double encode = encode_timer.Seconds();
+
+        std::vector<uint8_t> decoded(bytes.size());
+        bool valid = true;
+        Timer decode_timer;
+        for (size_t i = 0; i < iterations; i++)
+            valid &= Hex::Decode(upper, decoded.data(), isa);
+        double decode = decode_timer.Seconds();
+
+        // Every position of a non-hex char has to be caught.
+        std::string corrupt = reference.substr(0, 200);
+        bool rejects = true;
+        for (size_t pos = 0; pos < corrupt.size(); pos++) {
+            char saved = corrupt[pos];
+            corrupt[pos] = "g/:@G`\xff "[pos % 8];
+            rejects &= !Hex::Decode(corrupt, decoded.data(), isa);
+            corrupt[pos] = saved;
+        }
+        Hex::Decode(reference, decoded.data(), isa);
+
+        bool ok = hex == reference && valid && decoded == bytes && rejects;
+        failed += !ok;
+        std::cout << name << " encode: " << iterations * bytes.size() / encode / 1e9 << " GB/s, "
+                  << "decode: " << iterations * bytes.size() / decode / 1e9 << " GB/s"
+                  << (ok ? "" : "  MISMATCH") << std::endl;
+    }
+    return failed ? 1 : 0;
+}
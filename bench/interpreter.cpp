@@ -0,0 +1,129 @@
+#include "bench.hpp"
+
+#include "Script.hpp"
+#include "hashes.hpp"
+
+#include <random>
+
+// OPs the random scripts are built from (data pushes are added separately).
+static const std::vector<OpEnum> RANDOM_OPS = {
+    OP_0, OP_1, OP_2, OP_3, OP_16, OP_1NEGATE,
+    OP_NOP, OP_VERIFY, OP_RETURN,
+    OP_TOALTSTACK, OP_FROMALTSTACK, OP_IFDUP, OP_DEPTH, OP_DROP, OP_DUP,
+    OP_NIP, OP_OVER, OP_PICK, OP_ROLL, OP_ROT, OP_SWAP, OP_TUCK,
+    OP_2DROP, OP_2DUP, OP_3DUP, OP_2OVER, OP_2ROT, OP_2SWAP,
+    OP_SIZE, OP_EQUAL, OP_EQUALVERIFY,
+    OP_1ADD, OP_1SUB, OP_NEGATE, OP_ABS, OP_NOT, OP_0NOTEQUAL,
+    OP_ADD, OP_SUB, OP_BOOLAND, OP_BOOLOR, OP_NUMEQUAL, OP_NUMEQUALVERIFY,
+    OP_NUMNOTEQUAL, OP_LESSTHAN, OP_GREATERTHAN, OP_LESSTHANOREQUAL,
+    OP_GREATERTHANOREQUAL, OP_MIN, OP_MAX, OP_WITHIN,
+    OP_RIPEMD160, OP_SHA1, OP_SHA256, OP_HASH160, OP_HASH256,
+    OP_NOP1, OP_NOP4, OP_NOP10
+};
+
+// Differential corpus: a few hand-written scripts shaped like real ones
+// (hash locks, timelock-style arithmetic, nested conditionals) followed by
+// random OP sequences from a fixed seed, so every run checks the same set.
+static std::vector<Script> MakeCorpus(size_t n_random) {
+    std::vector<Script> corpus;
+
+    std::vector<uint8_t> secret(32, 0x42);
+    Script hashlock;
+    hashlock << secret << OP_SHA256 << sha256(secret) << OP_EQUALVERIFY
+             << OP_1;
+    corpus.push_back(hashlock);
+
+    Script htlc;
+    htlc << secret << OP_1
+         << OP_IF
+         <<     OP_HASH160 << hash160(secret) << OP_EQUAL
+         << OP_ELSE
+         <<     500000 << OP_NOP2 << OP_DROP << OP_0
+         << OP_ENDIF;
+    corpus.push_back(htlc);
+
+    Script arithmetic;
+    arithmetic << 1000 << 2000 << OP_ADD << 3000 << OP_NUMEQUALVERIFY
+               << 7 << OP_1SUB << 6 << OP_NUMEQUAL
+               << OP_IF << 5 << 0 << 10 << OP_WITHIN << OP_ELSE << OP_0 << OP_ENDIF;
+    corpus.push_back(arithmetic);
+
+    Script nested;
+    nested << OP_1 << OP_0
+           << OP_IF << OP_RETURN
+           << OP_ELSE << OP_1 << OP_IF << OP_2 << OP_ELSE << OP_3 << OP_ELSE << OP_4 << OP_ENDIF
+           << OP_ENDIF << OP_ADD << OP_5 << OP_EQUAL;
+    corpus.push_back(nested);
+
+    std::mt19937 rng(0xb17c0de);
+    auto pick = [&rng](size_t n) { return std::uniform_int_distribution<size_t>(0, n-1)(rng); };
+
+    for (size_t i = 0; i < n_random; i++) {
+        Script script;
+        size_t depth = 0;
+        // Some operands first so most scripts get past the first few OPs.
+        for (size_t n = 2 + pick(4); n > 0; n--)
+            script << (int32_t)(pick(40) - 8);
+        for (size_t n = 1 + pick(24); n > 0; n--) {
+            switch (pick(12)) {
+                case 0: // small data push
+                    script << std::vector<uint8_t>(1 + pick(pick(2) ? 4 : 33), (uint8_t)pick(256));
+                    break;
+                case 1:
+                    script << (pick(2) ? OP_IF : OP_NOTIF);
+                    depth++;
+                    break;
+                case 2:
+                    if (depth) script << OP_ELSE;
+                    break;
+                case 3:
+                    if (depth) { script << OP_ENDIF; depth--; }
+                    break;
+                default:
+                    script << RANDOM_OPS[pick(RANDOM_OPS.size())];
+            }
+        }
+        while (depth--)
+            script << OP_ENDIF;
+        corpus.push_back(script);
+    }
+    return corpus;
+}
+
+int BenchInterpreter(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 100;
+    auto   corpus     = MakeCorpus(5000);
+
+    // Both engines must agree on every script, value and error alike.
+    size_t mismatches = 0;
+    size_t succeeded  = 0;
+    for (auto& script: corpus) {
+        auto reference = script.Run(ScriptEngine::Reference);
+        auto threaded  = script.Run(ScriptEngine::Threaded);
+        succeeded += reference.HasValue();
+        if (reference.Error() == threaded.Error() && reference.Value() == threaded.Value())
+            continue;
+        if (mismatches++ < 10)
+            std::cout << "MISMATCH " << script << std::dec << std::endl
+                      << "    reference: " << (reference ? toHex(reference.Value()) : reference.Message()) << std::endl
+                      << "    threaded : " << (threaded ? toHex(threaded.Value()) : threaded.Message()) << std::endl;
+    }
+    std::cout << "corpus      : " << corpus.size() << " scripts, "
+              << succeeded << " succeed, " << mismatches << " mismatches" << std::endl;
+    if (mismatches)
+        return 1;
+
+    double seconds[2];
+    for (auto engine: {ScriptEngine::Reference, ScriptEngine::Threaded}) {
+        Timer timer;
+        for (size_t i = 0; i < iterations; i++)
+            for (auto& script: corpus)
+                script.Run(engine);
+        seconds[(int)engine] = timer.Seconds();
+        std::cout << (engine == ScriptEngine::Reference ? "reference   : " : "threaded    : ")
+                  << (size_t)(iterations * corpus.size() / seconds[(int)engine])
+                  << " scripts/s" << std::endl;
+    }
+    std::cout << "speedup     : " << seconds[0] / seconds[1] << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "bench.hpp"
+
+#include "Miner.hpp"
+#include "merkle.hpp"
+#include "HeaderChain.hpp"
+#include "validation.hpp"
+#include "sha256.hpp"
+#include "utils.hpp"
+
+#include <thread>
+#include <iostream>
+
+/* Mining: the nonce scan alone on one thread for each implementation, then
+   the Miner over `threads` on a difficulty 1 (mainnet minimum) header,
+   stopped after `seconds`, and `blocks` regtest blocks mined on top of each
+   other, checked by CheckBlock and a HeaderChain. Last, the cost of a new
+   coinbase (extranonce) for the synthetic block's merkle root: the whole
+   tree against the coinbase's branch. */
+int BenchMine(int argc, char** argv) {
+    size_t threads  = argc > 1 ? std::stoul(argv[1]) : std::thread::hardware_concurrency();
+    double seconds  = argc > 2 ? std::stod(argv[2]) : 2;
+    size_t n_blocks = argc > 3 ? std::stoul(argv[3]) : 1000;
+
+    BlockHeader header(0x20000000, Hash256{}, Hash256{}, 1600000000, 0x1d00ffff, 0);
+    auto serialized = header.Serialize();
+    auto midstate   = Sha256::INIT;
+    Sha256::Transform(midstate, serialized.data(), 1);
+
+    static const char* ISA_NAMES[] = {"scalar", "avx2  ", "sha-ni"};
+    const uint64_t n_nonces = 1 << 22;
+    for (auto isa: {Sha256::Isa::Scalar, Sha256::Isa::AVX2, Sha256::Isa::SHANI}) {
+        if (!Sha256::Supported(isa))
+            continue;
+        Timer timer;
+        Sha256::ScanNonces(midstate, serialized.data() + 64, 0, n_nonces, 0, isa);
+        std::cout << "scan " << ISA_NAMES[(int)isa] << " : "
+                  << n_nonces / timer.Seconds() / 1e6 << " MH/s" << std::endl;
+    }
+
+    ThreadPool pool(threads);
+    Miner      miner(pool);
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        miner.Stop();
+    });
+    auto mined = miner.MineHeader(header);
+    stopper.join();
+    auto stats = miner.GetStats();
+    std::cout << "miner x" << pool.Size() << "   : " << stats.GetHashrate() / 1e6 << " MH/s, "
+              << stats.hashes << " hashes" << (mined ? ", found " + toDisplayHex(mined->GetHash()) : "")
+              << std::endl;
+
+    auto&       params = ChainParams::Regtest();
+    HeaderChain chain(params);
+    Timer       timer;
+    for (size_t height = 1; height <= n_blocks; height++) {
+        auto& tip = chain.GetTip();
+        std::pmr::vector<TxIn>  inputs;
+        std::pmr::vector<TxOut> outputs;
+        inputs.emplace_back(OutPoint{Hash256{}, 0xffffffff}, Script(), 0xffffffff);
+        outputs.emplace_back(50 * COIN, Script() << OP_TRUE);
+        Block block(BlockHeader(4, tip.GetHash(), Hash256{}, tip.GetTime() + 1, 0x207fffff, 0), {});
+        block.AddTx(Tx(2, std::move(inputs), std::move(outputs), 0));
+        if (!miner.MineBlock(block, height, params))
+            throw std::runtime_error("stopped");
+        CheckBlock(block, true, true, params);
+        chain.AddHeaders(std::span<const BlockHeader>(&block.GetHeader(), 1));
+    }
+    std::cout << "regtest     : " << n_blocks << " blocks, " << (size_t)(n_blocks / timer.Seconds())
+              << " blocks/s, tip " << toDisplayHex(chain.GetHash(chain.GetHeight())) << std::endl;
+
+    Block          block(MakeBlock());
+    CoinbaseBranch branch(block);
+    const size_t   iterations = 1000;
+    Hash256        coinbase_txid{};
+    Timer          tree_timer;
+    for (size_t i = 0; i < iterations; i++) {
+        coinbase_txid[0] = (uint8_t)i;
+        std::vector<Hash256> txids;
+        txids.reserve(block.GetTxs().size());
+        txids.push_back(coinbase_txid);
+        for (size_t j = 1; j < block.GetTxs().size(); j++)
+            txids.push_back(block.GetTxs()[j].GetTxId());
+        ComputeMerkleRoot(std::move(txids));
+    }
+    double tree_seconds = tree_timer.Seconds();
+    Timer  branch_timer;
+    for (size_t i = 0; i < iterations; i++) {
+        coinbase_txid[0] = (uint8_t)i;
+        branch.GetRoot(coinbase_txid);
+    }
+    double branch_seconds = branch_timer.Seconds();
+    if (branch.GetRoot(block.GetTxs()[0].GetTxId()) != block.GetHeader().GetMerkleRoot())
+        throw std::runtime_error("merkle branch mismatch");
+    std::cout << "new coinbase: " << block.GetTxs().size() << " txs, tree "
+              << tree_seconds / iterations * 1e6 << " us, branch (" << branch.GetHashes().size()
+              << " hashes) " << branch_seconds / iterations * 1e6 << " us" << std::endl;
+    return 0;
+}
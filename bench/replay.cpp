@@ -0,0 +1,157 @@
+#include "bench.hpp"
+
+#include "Block.hpp"
+#include "BlockFiles.hpp"
+#include "ThreadPool.hpp"
+#include "merkle.hpp"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
+
+// An input to verify: its scriptSig against the scriptPubKey it spends.
+struct Spend {
+    const TxIn*   input;
+    const Script* script_pubkey;
+};
+
+/* Replays a directory of blocks through the stages of block validation that
+   don't need a database, each timed on its own over all the blocks:
+
+       parse    Block from bytes (heap allocated, as a library user would)
+       hash     txids and wtxids
+       merkle   merkle root check against the header
+       utxo     resolving each input's spent output, from the outputs of the
+                blocks replayed before it (in-memory, sequential)
+       script   Script::Verify of every resolved input (P2SH, threaded
+                engine); signature checks and witness programs aren't
+                implemented, so this is the interpreter's cost without them
+
+   Blocks are either one file per block (binary or hex, see LoadBlock), in
+   file name order, e.g. named after their height, or Bitcoin Core's
+   blocks/ directory (blk*.dat, best chain order). Stages run over `threads`
+   a block / a batch of inputs at a time, except utxo. Inputs spending
+   outputs from before the first block aren't verified. */
+int BenchReplay(int argc, char** argv) {
+    if (argc < 2)
+        throw std::runtime_error("usage: replay <blocks dir> [threads] [blocks]");
+    std::string dir        = argv[1];
+    size_t      threads    = argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+    size_t      max_blocks = argc > 3 ? std::stoul(argv[3]) : SIZE_MAX;
+
+    std::unique_ptr<BlockFiles>       blk_files;
+    std::vector<std::vector<uint8_t>> loaded;
+    std::vector<std::span<const uint8_t>> serialized;
+    if (std::filesystem::exists(dir + "/blk00000.dat")) {
+        blk_files = std::make_unique<BlockFiles>(dir);
+        blk_files->Advise(BlockFiles::Access::Sequential);
+        size_t n_blocks = std::min<size_t>(blk_files->GetHeight() + 1, max_blocks);
+        for (size_t height = 0; height < n_blocks; height++)
+            serialized.push_back(blk_files->GetBlock(height));
+    } else {
+        std::vector<std::string> paths;
+        for (auto& entry: std::filesystem::directory_iterator(dir))
+            if (entry.is_regular_file())
+                paths.push_back(entry.path());
+        std::sort(paths.begin(), paths.end());
+        for (size_t i = 0; i < paths.size() && i < max_blocks; i++)
+            loaded.push_back(LoadBlock(paths[i]));
+        serialized.assign(loaded.begin(), loaded.end());
+    }
+    size_t bytes = 0;
+    for (auto& block: serialized)
+        bytes += block.size();
+
+    ThreadPool pool(threads);
+    std::vector<std::optional<Block>> blocks(serialized.size());
+    size_t   n_txs = 0, n_inputs = 0;
+    double   total_seconds     = 0;
+    uint64_t total_allocations = 0;
+
+    auto report = [&](const char* name, double seconds, uint64_t allocated) {
+        total_seconds     += seconds;
+        total_allocations += allocated;
+        std::cout << name << ": " << seconds * 1e3 << " ms, " << (size_t)(n_txs / seconds) << " tx/s, "
+                  << (size_t)(n_inputs / seconds) << " inputs/s, "
+                  << (double)allocated / std::max<size_t>(n_txs, 1) << " allocs/tx" << std::endl;
+    };
+    // Runs `fn` over `pool`, timed, with the allocations it made.
+    auto stage = [&](const char* name, size_t count, size_t grain, auto&& fn) {
+        uint64_t start_allocations = AllocationCount();
+        Timer    timer;
+        pool.ParallelFor(count, [&](size_t i, size_t) { fn(i); }, grain);
+        report(name, timer.Seconds(), AllocationCount() - start_allocations);
+    };
+
+    // Parse first, the counts are needed for the report.
+    uint64_t parse_allocations = AllocationCount();
+    Timer    parse_timer;
+    pool.ParallelFor(blocks.size(), [&](size_t i, size_t) { blocks[i].emplace(serialized[i]); });
+    double parse_seconds = parse_timer.Seconds();
+    parse_allocations    = AllocationCount() - parse_allocations;
+    for (auto& block: blocks) {
+        n_txs += block->GetTxs().size();
+        for (auto& tx: block->GetTxs())
+            n_inputs += tx.GetInputs().size();
+    }
+    std::cout << "blocks      : " << blocks.size() << " blocks, " << n_txs << " txs, " << n_inputs
+              << " inputs, " << bytes << " bytes, " << pool.Size() << " threads" << std::endl;
+
+    report("parse       ", parse_seconds, parse_allocations);
+
+    stage("hash        ", blocks.size(), 1, [&](size_t i) {
+        for (auto& tx: blocks[i]->GetTxs()) {
+            tx.GetTxId();
+            tx.GetWTxId();
+        }
+    });
+
+    std::atomic<size_t> bad_roots = 0;
+    stage("merkle      ", blocks.size(), 1, [&](size_t i) {
+        bool mutated;
+        if (BlockMerkleRoot(*blocks[i], &mutated) != blocks[i]->GetHeader().GetMerkleRoot() || mutated)
+            bad_roots++;
+    });
+
+    // Spent outputs by outpoint, pointing into `blocks`.
+    uint64_t utxo_allocations = AllocationCount();
+    Timer    utxo_timer;
+    std::unordered_map<OutPoint, const Script*> utxos;
+    std::vector<Spend> spends;
+    size_t unresolved = 0, witness = 0;
+    for (auto& block: blocks)
+        for (auto& tx: block->GetTxs()) {
+            if (!tx.IsCoinBase())
+                for (auto& input: tx.GetInputs()) {
+                    auto spent = utxos.find(input.GetPrevOut());
+                    if (spent == utxos.end()) {
+                        unresolved++;
+                        continue;
+                    }
+                    witness += !input.GetWitness().empty();
+                    spends.push_back({&input, spent->second});
+                    utxos.erase(spent);
+                }
+            for (uint32_t n = 0; n < tx.GetOutputs().size(); n++)
+                utxos.emplace(OutPoint{tx.GetTxId(), n}, &tx.GetOutputs()[n].GetScript());
+        }
+    report("utxo        ", utxo_timer.Seconds(), AllocationCount() - utxo_allocations);
+
+    std::atomic<size_t> failed = 0;
+    stage("script      ", spends.size(), 64, [&](size_t i) {
+        if (Script::Verify(spends[i].input->GetScript(), *spends[i].script_pubkey, SCRIPT_VERIFY_P2SH,
+                           ScriptEngine::Threaded) != SCRIPT_ERR_OK)
+            failed++;
+    });
+
+    report("total       ", total_seconds, total_allocations);
+    std::cout << "scripts     : " << spends.size() << " verified (" << witness << " with witnesses), "
+              << failed << " failed, " << unresolved << " unresolved" << std::endl;
+    if (bad_roots)
+        throw std::runtime_error(std::to_string(bad_roots) + " blocks with a bad merkle root");
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "bench.hpp"
+
+#include "Tx.hpp"
+#include "TxView.hpp"
+#include "txformat.hpp"
+
+#include <algorithm>
+
+// A ~125 kB segwit transaction shaped like a large consolidation/payout:
+// P2PKH-sized scriptSigs on half of the inputs, P2WPKH-sized witnesses on
+// the other half, P2PKH scripts on the way out.
+static std::vector<uint8_t> MakeLargeTx() {
+    std::pmr::vector<TxIn>  inputs;
+    std::pmr::vector<TxOut> outputs;
+    for (uint32_t i = 0; i < 500; i++) {
+        Script script_sig;
+        Witness witness;
+        if (i % 2)
+            witness = {std::pmr::vector<uint8_t>(72, (uint8_t)i), std::pmr::vector<uint8_t>(33, 0x02)};
+        else
+            script_sig << std::vector<uint8_t>(72, (uint8_t)i) << std::vector<uint8_t>(33, 0x02);
+        OutPoint prevout;
+        prevout.txid.fill((uint8_t)i);
+        prevout.n = i;
+        inputs.emplace_back(prevout, std::move(script_sig), 0xffffffff, std::move(witness));
+    }
+    for (uint32_t i = 0; i < 1500; i++)
+        outputs.emplace_back(1000 + i, Script() << OP_DUP << OP_HASH160
+                                                << std::vector<uint8_t>(20, (uint8_t)i)
+                                                << OP_EQUALVERIFY << OP_CHECKSIG);
+    return Tx(1, std::move(inputs), std::move(outputs), 0).Serialize();
+}
+
+int BenchTxParse(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 1000;
+    auto   serialized = MakeLargeTx();
+
+    auto report = [&](const char* name, double seconds) {
+        std::cout << name << ": " << seconds / iterations * 1e6 << " us/tx, "
+                  << (size_t)(iterations * serialized.size() / seconds / 1e6) << " MB/s" << std::endl;
+    };
+    std::cout << "tx size     : " << serialized.size() << " bytes" << std::endl;
+
+    size_t check = 0;
+    Timer tx_timer;
+    for (size_t i = 0; i < iterations; i++)
+        check += Tx(serialized).GetOutputs().size();
+    report("Tx          ", tx_timer.Seconds());
+
+    Timer view_timer;
+    for (size_t i = 0; i < iterations; i++)
+        check += TxView(serialized).OutputCount();
+    report("TxView      ", view_timer.Seconds());
+
+    Tx     tx(serialized);
+    TxView view(serialized);
+    if (tx.Serialize() != serialized)
+        throw std::runtime_error("Tx doesn't serialize back to its input");
+    if (tx.GetTxId() != view.TxId() || tx.GetWTxId() != view.WTxId() ||
+        tx.GetWeight() != view.Weight())
+        throw std::runtime_error("Tx and TxView disagree on ids or weight");
+
+    Timer ids_timer;
+    for (size_t i = 0; i < iterations; i++) {
+        Tx parsed(serialized);
+        check += parsed.GetTxId()[0] + parsed.GetWTxId()[0] + parsed.GetWeight();
+    }
+    report("Tx + ids    ", ids_timer.Seconds());
+
+    std::vector<uint8_t> out(tx.GetSerializedSize());
+    Timer ser_timer;
+    for (size_t i = 0; i < iterations; i++)
+        check += tx.Serialize(out);
+    report("Tx serialize", ser_timer.Seconds());
+
+    std::string buffer(FormatTx(view, TxFormat::Json, {}), '\0');
+    Timer json_timer;
+    for (size_t i = 0; i < iterations; i++)
+        check += FormatTx(view, TxFormat::Json, buffer);
+    report("json format ", json_timer.Seconds());
+
+    return check == 0;
+}
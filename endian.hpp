@@ -0,0 +1,78 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/* Fixed-width integers from/to raw bytes, in either byte order, like Core's
+   crypto/common.h. At runtime they're a memcpy plus a byte swap when the
+   host order differs, which compilers turn into a single mov (or movbe /
+   mov + bswap); in constant expressions they fall back to shifts. */
+
+template <typename T>
+constexpr T ByteSwap(T value) {
+    static_assert(std::is_unsigned_v<T>);
+    if constexpr (sizeof(T) == 1)
+        return value;
+    else if constexpr (sizeof(T) == 2)
+        return __builtin_bswap16(value);
+    else if constexpr (sizeof(T) == 4)
+        return __builtin_bswap32(value);
+    else
+        return __builtin_bswap64(value);
+}
+
+template <typename T, std::endian Order>
+constexpr T ReadInt(const uint8_t* ptr) {
+    using U = std::make_unsigned_t<T>;
+    U value = 0;
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i < sizeof(T); i++) {
+            size_t shift = Order == std::endian::little ? i : sizeof(T) - 1 - i;
+            value |= (U)((U)ptr[i] << (8 * shift));
+        }
+        return (T)value;
+    }
+    std::memcpy(&value, ptr, sizeof(T));
+    if constexpr (Order != std::endian::native)
+        value = ByteSwap(value);
+    return (T)value;
+}
+
+template <typename T, std::endian Order>
+constexpr void WriteInt(uint8_t* ptr, T value) {
+    using U = std::make_unsigned_t<T>;
+    U bits = (U)value;
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i < sizeof(T); i++) {
+            size_t shift = Order == std::endian::little ? i : sizeof(T) - 1 - i;
+            ptr[i] = (uint8_t)(bits >> (8 * shift));
+        }
+        return;
+    }
+    if constexpr (Order != std::endian::native)
+        bits = ByteSwap(bits);
+    std::memcpy(ptr, &bits, sizeof(T));
+}
+
+// Any integer type, little-endian (the serialization order).
+template <typename T>
+constexpr T    ReadLE(const uint8_t* ptr)           { return ReadInt<T, std::endian::little>(ptr); }
+template <typename T>
+constexpr void WriteLE(uint8_t* ptr, T value)       { WriteInt<T, std::endian::little>(ptr, value); }
+
+constexpr uint16_t ReadLE16(const uint8_t* ptr)     { return ReadLE<uint16_t>(ptr); }
+constexpr uint32_t ReadLE32(const uint8_t* ptr)     { return ReadLE<uint32_t>(ptr); }
+constexpr uint64_t ReadLE64(const uint8_t* ptr)     { return ReadLE<uint64_t>(ptr); }
+constexpr void     WriteLE16(uint8_t* ptr, uint16_t x) { WriteLE(ptr, x); }
+constexpr void     WriteLE32(uint8_t* ptr, uint32_t x) { WriteLE(ptr, x); }
+constexpr void     WriteLE64(uint8_t* ptr, uint64_t x) { WriteLE(ptr, x); }
+
+// Big-endian, for network byte order fields (ports, addresses).
+constexpr uint16_t ReadBE16(const uint8_t* ptr)     { return ReadInt<uint16_t, std::endian::big>(ptr); }
+constexpr uint32_t ReadBE32(const uint8_t* ptr)     { return ReadInt<uint32_t, std::endian::big>(ptr); }
+constexpr uint64_t ReadBE64(const uint8_t* ptr)     { return ReadInt<uint64_t, std::endian::big>(ptr); }
+constexpr void     WriteBE16(uint8_t* ptr, uint16_t x) { WriteInt<uint16_t, std::endian::big>(ptr, x); }
+constexpr void     WriteBE32(uint8_t* ptr, uint32_t x) { WriteInt<uint32_t, std::endian::big>(ptr, x); }
+constexpr void     WriteBE64(uint8_t* ptr, uint64_t x) { WriteInt<uint64_t, std::endian::big>(ptr, x); }
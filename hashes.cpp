@@ -31,6 +31,16 @@ std::vector<uint8_t> hash256(const std::vector<uint8_t>& input) {
     return sha256(sha256(input));
 }
 
+std::vector<uint8_t> hash256(std::initializer_list<std::span<const uint8_t>> parts) {
+    SHA256_CTX sctx;
+    SHA256_Init(&sctx);
+    for (auto& part: parts)
+        SHA256_Update(&sctx, part.data(), part.size());
+    std::vector<uint8_t> md(SHA256_DIGEST_LENGTH);
+    SHA256_Final(md.data(), &sctx);
+    return sha256(md);
+}
+
 std::vector<uint8_t> hash160(const std::vector<uint8_t>& input) {
     return ripemd160(sha256(input));
 }
\ No newline at end of file
@@ -1,9 +1,23 @@
 #pragma once
 
+#include "endian.hpp"
+
 #include <openssl/sha.h>
 #include <openssl/ripemd.h>
 
 #include <vector>
+#include <array>
+#include <span>
+#include <initializer_list>
+
+// 32-byte hash (txid, block hash...), serialized byte order.
+using Hash256 = std::array<uint8_t, 32>;
+
+// For unordered containers keyed by txid / block hash: 8 of the bytes are
+// already uniformly distributed. Not salted, see std::hash<OutPoint>.
+struct Hash256Hasher {
+    size_t operator()(const Hash256& hash) const noexcept { return ReadLE64(hash.data()); }
+};
 
 std::vector<uint8_t> sha256(const std::vector<uint8_t>& input);
 std::vector<uint8_t> sha1(const std::vector<uint8_t>& input);
@@ -11,5 +25,7 @@ std::vector<uint8_t> ripemd160(const std::vector<uint8_t>& input);
 
 // sha256(sha256())
 std::vector<uint8_t> hash256(const std::vector<uint8_t>& input);
+// hash256() of the concatenation of `parts`, without building it.
+std::vector<uint8_t> hash256(std::initializer_list<std::span<const uint8_t>> parts);
 // ripemd160(sha256())
 std::vector<uint8_t> hash160(const std::vector<uint8_t>& input);
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "hex.hpp"
+
+#include <array>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HEX_X86 1
+#endif
+
+namespace Hex {
+
+////////////////////////////////// SCALAR ////////////////////////////////////
+
+// Both chars of every byte.
+static constexpr auto ENCODE_TABLE = [] {
+    std::array<char, 512> table{};
+    const char* digits = "0123456789abcdef";
+    for (size_t b = 0; b < 256; b++) {
+        table[2*b]     = digits[b >> 4];
+        table[2*b + 1] = digits[b & 0x0f];
+    }
+    return table;
+}();
+
+// Nibble of every char, -1 if it isn't a hex digit.
+static constexpr auto DECODE_TABLE = [] {
+    std::array<int8_t, 256> table{};
+    for (size_t c = 0; c < 256; c++)
+        table[c] = c >= '0' && c <= '9' ? c - '0'
+                 : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+    return table;
+}();
+
+static char* EncodeScalar(const uint8_t* in, size_t n, char* out) {
+    for (size_t i = 0; i < n; i++) {
+        out[2*i]     = ENCODE_TABLE[2*in[i]];
+        out[2*i + 1] = ENCODE_TABLE[2*in[i] + 1];
+    }
+    return out + 2*n;
+}
+
+static bool DecodeScalar(const char* in, size_t n, uint8_t* out) {
+    int8_t invalid = 0; // sign bit set by any -1, checked once at the end
+    for (size_t i = 0; i < n; i++) {
+        int8_t hi = DECODE_TABLE[(uint8_t)in[2*i]];
+        int8_t lo = DECODE_TABLE[(uint8_t)in[2*i + 1]];
+        invalid |= hi | lo;
+        out[i] = (uint8_t)(hi << 4 | lo);
+    }
+    return invalid >= 0;
+}
+
+#ifdef HEX_X86
+
+/////////////////////////////////// SSSE3 ////////////////////////////////////
+
+// Nibbles to chars with one pshufb each, interleaved back into pairs.
+__attribute__((target("ssse3")))
+static char* EncodeSSSE3(const uint8_t* in, size_t n, char* out) {
+    const __m128i digits = _mm_setr_epi8('0','1','2','3','4','5','6','7',
+                                         '8','9','a','b','c','d','e','f');
+    const __m128i mask   = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i hi    = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), mask));
+        __m128i lo    = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, mask));
+        _mm_storeu_si128((__m128i*)(out + 2*i),      _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(out + 2*i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return EncodeScalar(in + i, n - i, out + 2*i);
+}
+
+// 16 chars to nibbles, all lanes 0xff in `valid` if they were hex digits.
+__attribute__((target("ssse3")))
+static __m128i Nibbles(__m128i chars, __m128i& valid) {
+    __m128i digit    = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    __m128i letter   = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    valid = _mm_and_si128(valid, _mm_or_si128(is_digit, is_alpha));
+    return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                        _mm_and_si128(is_alpha, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+// hi * 16 + lo for every pair of nibbles (pmaddubsw), then packed to bytes.
+__attribute__((target("ssse3")))
+static bool DecodeSSSE3(const char* in, size_t n, uint8_t* out) {
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    __m128i valid = _mm_set1_epi8(-1);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = Nibbles(_mm_loadu_si128((const __m128i*)(in + 2*i)), valid);
+        __m128i b = Nibbles(_mm_loadu_si128((const __m128i*)(in + 2*i + 16)), valid);
+        _mm_storeu_si128((__m128i*)(out + i),
+            _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights)));
+    }
+    return _mm_movemask_epi8(valid) == 0xffff && DecodeScalar(in + 2*i, n - i, out + i);
+}
+
+/////////////////////////////////// AVX2 /////////////////////////////////////
+
+// Same as SSSE3 on two lanes, unpack and pack work per 128-bit lane so the
+// halves get put back in order with a cross-lane permute.
+__attribute__((target("avx2")))
+static char* EncodeAVX2(const uint8_t* in, size_t n, char* out) {
+    const __m256i digits = _mm256_setr_epi8('0','1','2','3','4','5','6','7',
+                                            '8','9','a','b','c','d','e','f',
+                                            '0','1','2','3','4','5','6','7',
+                                            '8','9','a','b','c','d','e','f');
+    const __m256i mask   = _mm256_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i hi    = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), mask));
+        __m256i lo    = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, mask));
+        __m256i first = _mm256_unpacklo_epi8(hi, lo); // bytes 0-7, 16-23
+        __m256i last  = _mm256_unpackhi_epi8(hi, lo); // bytes 8-15, 24-31
+        _mm256_storeu_si256((__m256i*)(out + 2*i),      _mm256_permute2x128_si256(first, last, 0x20));
+        _mm256_storeu_si256((__m256i*)(out + 2*i + 32), _mm256_permute2x128_si256(first, last, 0x31));
+    }
+    return EncodeSSSE3(in + i, n - i, out + 2*i);
+}
+
+__attribute__((target("avx2")))
+static __m256i Nibbles(__m256i chars, __m256i& valid) {
+    __m256i digit    = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    __m256i letter   = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i is_alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+    valid = _mm256_and_si256(valid, _mm256_or_si256(is_digit, is_alpha));
+    return _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+                           _mm256_and_si256(is_alpha, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+}
+
+__attribute__((target("avx2")))
+static bool DecodeAVX2(const char* in, size_t n, uint8_t* out) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    __m256i valid = _mm256_set1_epi8(-1);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i a = Nibbles(_mm256_loadu_si256((const __m256i*)(in + 2*i)), valid);
+        __m256i b = Nibbles(_mm256_loadu_si256((const __m256i*)(in + 2*i + 32)), valid);
+        __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights),
+                                             _mm256_maddubs_epi16(b, weights));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_permute4x64_epi64(packed, 0xd8));
+    }
+    return _mm256_movemask_epi8(valid) == -1 && DecodeSSSE3(in + 2*i, n - i, out + i);
+}
+
+#endif // HEX_X86
+
+//////////////////////////////////////////////////////////////////////////////
+
+Isa Detect() {
+#ifdef HEX_X86
+    static const Isa best = __builtin_cpu_supports("avx2")  ? Isa::AVX2
+                          : __builtin_cpu_supports("ssse3") ? Isa::SSSE3 : Isa::Scalar;
+    return best;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+char* Encode(std::span<const uint8_t> bytes, char* out, Isa isa) {
+#ifdef HEX_X86
+    if (isa == Isa::AVX2)
+        return EncodeAVX2(bytes.data(), bytes.size(), out);
+    if (isa == Isa::SSSE3)
+        return EncodeSSSE3(bytes.data(), bytes.size(), out);
+#endif
+    return EncodeScalar(bytes.data(), bytes.size(), out);
+}
+
+bool Decode(std::string_view hex, uint8_t* out, Isa isa) {
+    if (hex.size() % 2)
+        return false;
+#ifdef HEX_X86
+    if (isa == Isa::AVX2)
+        return DecodeAVX2(hex.data(), hex.size() / 2, out);
+    if (isa == Isa::SSSE3)
+        return DecodeSSSE3(hex.data(), hex.size() / 2, out);
+#endif
+    return DecodeScalar(hex.data(), hex.size() / 2, out);
+}
+
+}
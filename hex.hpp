@@ -0,0 +1,23 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <cstdint>
+
+// Hex codecs: a table-driven scalar one, plus SSSE3 (16 bytes at a time) and
+// AVX2 (32 bytes) ones on x86, picked at runtime. See utils.hpp for the
+// std::string / std::vector wrappers.
+namespace Hex {
+    enum class Isa { Scalar, SSSE3, AVX2 };
+
+    // Best codec this CPU supports.
+    Isa Detect();
+
+    // Lowercase hex of `bytes` into `out` (2 chars per byte), returns the end.
+    char* Encode(std::span<const uint8_t> bytes, char* out, Isa isa = Detect());
+
+    // Strict decoding of `hex` (even length, 0-9a-fA-F only, no prefix or
+    // whitespace) into `out` (hex.size() / 2 bytes). Returns false on invalid
+    // input, `out` is then partially written.
+    bool Decode(std::string_view hex, uint8_t* out, Isa isa = Detect());
+}
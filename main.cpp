@@ -29,7 +29,8 @@ int main() {
     std::cout << "Public Key         : " << public_key << std::endl;
     std::cout << "Public Key Address : " << public_key.Address() << std::endl;
 
-    std::vector<uint8_t> hash      = hash256(hex2bytes("the truth is out there"));
+    std::string          message   = "the truth is out there";
+    std::vector<uint8_t> hash      = hash256(std::vector<uint8_t>(message.begin(), message.end()));
     std::vector<uint8_t> signature = private_key.Sign(hash);
 
     std::cout << "Hash               : " << toHex(hash) << std::endl;
@@ -57,6 +58,7 @@ int main() {
     std::cout << script << std::endl << std::endl;
 
     std::cout << "Script Flow:" << std::endl;
+    script.SetTrace(true);
     auto result = script.Run();
 
     // std::cout << std::endl << "Script Output: " << std::endl;
@@ -111,8 +113,8 @@ int main() {
         throw std::runtime_error("Failed to fecth transaction");
 
     Tx tmp(hex2bytes(res_tx));
-    Script locking_script = tmp.outputs[txid_idx].GetScript();
-    auto in_amount = tmp.outputs[txid_idx].GetSatoshis();
+    Script locking_script = tmp.GetOutputs()[txid_idx].GetScript();
+    auto in_amount = tmp.GetOutputs()[txid_idx].GetSatoshis();
 
     // Recipient hash160
     auto recipient_address_bytes = Base58::Decode(address);
@@ -0,0 +1,77 @@
+#include "merkle.hpp"
+#include "Block.hpp"
+#include "HashWriter.hpp"
+
+// hash256() of two concatenated hashes.
+static Hash256 HashPair(const Hash256& left, const Hash256& right) {
+    HashWriter hasher;
+    hasher.WriteBytes(left);
+    hasher.WriteBytes(right);
+    return hasher.GetHash();
+}
+
+Hash256 ComputeMerkleRoot(std::vector<Hash256> hashes, bool* mutated) {
+    bool mutation = false;
+    while (hashes.size() > 1) {
+        for (size_t i = 0; i + 1 < hashes.size(); i += 2)
+            mutation |= hashes[i] == hashes[i + 1];
+        if (hashes.size() & 1)
+            hashes.push_back(hashes.back());
+        // Each level in place over the first half of the previous one.
+        for (size_t i = 0; i < hashes.size() / 2; i++)
+            hashes[i] = HashPair(hashes[2 * i], hashes[2 * i + 1]);
+        hashes.resize(hashes.size() / 2);
+    }
+    if (mutated)
+        *mutated = mutation;
+    return hashes.empty() ? Hash256{} : hashes[0];
+}
+
+Hash256 BlockMerkleRoot(const Block& block, bool* mutated) {
+    std::vector<Hash256> leaves;
+    leaves.reserve(block.GetTxs().size());
+    for (auto& tx: block.GetTxs())
+        leaves.push_back(tx.GetTxId());
+    return ComputeMerkleRoot(std::move(leaves), mutated);
+}
+
+Hash256 BlockWitnessMerkleRoot(const Block& block, bool* mutated) {
+    std::vector<Hash256> leaves;
+    leaves.reserve(block.GetTxs().size());
+    if (!block.GetTxs().empty())
+        leaves.emplace_back(); // coinbase
+    for (size_t i = 1; i < block.GetTxs().size(); i++)
+        leaves.push_back(block.GetTxs()[i].GetWTxId());
+    return ComputeMerkleRoot(std::move(leaves), mutated);
+}
+
+CoinbaseBranch::CoinbaseBranch(std::span<const Hash256> txids) {
+    std::vector<Hash256> level(txids.begin(), txids.end());
+    while (level.size() > 1) {
+        branch.push_back(level[1]);
+        if (level.size() & 1)
+            level.push_back(level.back());
+        // Level 0's first hash, hence the first of every level, is unknown:
+        // left as is, only the others are used.
+        for (size_t i = 1; i < level.size() / 2; i++)
+            level[i] = HashPair(level[2 * i], level[2 * i + 1]);
+        level.resize(level.size() / 2);
+    }
+}
+
+// The coinbase's txid isn't computed.
+static std::vector<Hash256> BranchLeaves(const Block& block) {
+    std::vector<Hash256> txids(block.GetTxs().size());
+    for (size_t i = 1; i < txids.size(); i++)
+        txids[i] = block.GetTxs()[i].GetTxId();
+    return txids;
+}
+
+CoinbaseBranch::CoinbaseBranch(const Block& block): CoinbaseBranch(BranchLeaves(block)) {}
+
+Hash256 CoinbaseBranch::GetRoot(const Hash256& coinbase_txid) const {
+    Hash256 root = coinbase_txid;
+    for (auto& sibling: branch)
+        root = HashPair(root, sibling);
+    return root;
+}
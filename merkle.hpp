@@ -0,0 +1,40 @@
+#pragma once
+
+#include "hashes.hpp"
+
+#include <span>
+#include <vector>
+
+class Block;
+
+// Merkle root of `hashes` (serialized order), Bitcoin Core's algorithm:
+// odd levels pair their last hash with itself. That makes a list and the
+// same list with its tail duplicated share a root (CVE-2012-2459), so
+// `mutated` reports two identical hashes paired with each other, which a
+// block with distinct transactions can't have. All zeros when empty.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/consensus/merkle.cpp
+Hash256 ComputeMerkleRoot(std::vector<Hash256> hashes, bool* mutated = nullptr);
+
+// Over the txids / the wtxids, the coinbase's counting as zero (BIP141).
+Hash256 BlockMerkleRoot(const Block& block, bool* mutated = nullptr);
+Hash256 BlockWitnessMerkleRoot(const Block& block, bool* mutated = nullptr);
+
+/* Path from the coinbase (leaf 0) to the root: the sibling of its subtree at
+   each level. The rest of the tree doesn't depend on the coinbase, so when
+   only the coinbase changes (extranonce, fees) the root takes log2(n)
+   hashes from its new txid instead of n over all of them. */
+class CoinbaseBranch {
+public:
+    // From the txids / a block's (the coinbase's own isn't used).
+    explicit CoinbaseBranch(std::span<const Hash256> txids);
+    explicit CoinbaseBranch(const Block& block);
+
+    // Root of the block with `coinbase_txid` as its first transaction.
+    Hash256 GetRoot(const Hash256& coinbase_txid) const;
+
+    // Siblings, bottom up.
+    const std::vector<Hash256>& GetHashes() const { return branch; }
+
+private:
+    std::vector<Hash256> branch;
+};
@@ -0,0 +1,39 @@
+#include "pow.hpp"
+
+#include <algorithm>
+
+bool CheckProofOfWork(const Hash256& hash, uint32_t bits, const ChainParams& params) {
+    bool negative, overflow;
+    Uint256 target = Uint256::FromCompact(bits, &negative, &overflow);
+    if (negative || overflow || target == 0 || target > params.pow_limit)
+        return false;
+    return Uint256(hash) <= target;
+}
+
+Uint256 GetBlockProof(uint32_t bits) {
+    bool negative, overflow;
+    Uint256 target = Uint256::FromCompact(bits, &negative, &overflow);
+    if (negative || overflow || target == 0)
+        return 0;
+    // 2^256 doesn't fit, but it is (2^256 - target - 1) / (target + 1) + 1.
+    return ~target / (target + 1) + 1;
+}
+
+uint32_t CalculateNextWorkRequired(uint32_t last_bits, int64_t last_time, int64_t first_time,
+                                   const ChainParams& params) {
+    if (params.pow_no_retargeting)
+        return last_bits;
+
+    int64_t timespan = std::clamp(last_time - first_time,
+                                  params.pow_target_timespan / 4, params.pow_target_timespan * 4);
+
+    // Multiply first, as Core does: the rounding is consensus, and so is
+    // the wrap-around for targets above ~2^233 (regtest's limit, but regtest
+    // doesn't retarget).
+    Uint256 target = Uint256::FromCompact(last_bits);
+    target *= (uint32_t)timespan;
+    target /= (uint64_t)params.pow_target_timespan;
+    if (target > params.pow_limit)
+        target = params.pow_limit;
+    return target.GetCompact();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "hashes.hpp"
+#include "Uint256.hpp"
+#include "ChainParams.hpp"
+
+#include <cstdint>
+
+// Hashes and targets compared as 256-bit numbers, which is how proof of work
+// reads them: little-endian, i.e. the serialized order is least significant
+// byte first. Display order (block explorers) is the reverse.
+
+// `hash` at most the target of `bits`, itself valid (positive, no overflow)
+// and at most the network's limit.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/pow.cpp#L74
+bool CheckProofOfWork(const Hash256& hash, uint32_t bits, const ChainParams& params = ChainParams::Main());
+
+// Expected number of hashes for a block of `bits`, 2^256 / (target + 1):
+// what chain work adds up.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/chain.cpp#L122
+Uint256 GetBlockProof(uint32_t bits);
+
+// nBits of the block after a retarget period that started at `first_time`
+// and ended with a block of `last_bits` at `last_time`: the target scaled by
+// how long the period actually took, at most 4x either way.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/pow.cpp#L49
+uint32_t CalculateNextWorkRequired(uint32_t last_bits, int64_t last_time, int64_t first_time,
+                                   const ChainParams& params = ChainParams::Main());
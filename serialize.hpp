@@ -0,0 +1,196 @@
+#pragma once
+
+#include "CompactSize.hpp"
+#include "endian.hpp"
+
+#include <span>
+#include <array>
+#include <vector>
+#include <memory_resource>
+#include <cstdint>
+#include <cstring>
+#include <concepts>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+/* Generic (de)serialization, in the spirit of Bitcoin Core's serialize.h.
+
+   A type describes its wire format once, as member templates
+       template <typename Stream> void Serialize(Stream& s) const;
+       template <typename Stream> void Unserialize(Stream& s);
+   written in terms of ::Serialize / ::Unserialize of its fields, and the
+   same description then drives any stream:
+       Writer        caller-provided span       (Writer.hpp)
+       VectorWriter  appends to a vector        (Writer.hpp)
+       SizeComputer  only counts bytes          (Writer.hpp)
+       HashWriter    double-SHA256 on the fly   (HashWriter.hpp)
+       SocketWriter  buffered file descriptor   (SocketWriter.hpp)
+       Reader        span, for Unserialize      (Reader.hpp)
+   Everything is a template so it gets inlined down to plain stores.
+
+   Wire format of the basic types:
+       integers                    little-endian, sizeof(T) bytes
+       std::array<uint8_t, N>      N raw bytes
+       std::vector<T>              CompactSize count, then each element
+   std::pmr::vector elements that can be built from (stream, memory_resource*)
+   get the vector's resource, so a parse can be kept in one arena. */
+
+// Anything bytes can be written to / read from.
+template <typename S>
+concept OutStream = requires(S& s, std::span<const uint8_t> bytes) { s.WriteBytes(bytes); };
+template <typename S>
+concept InStream  = requires(S& s, size_t n) {
+    { s.ReadBytes(n) } -> std::convertible_to<std::span<const uint8_t>>;
+};
+
+// Serialized size known at compile time, 0 for variable-size types.
+template <typename T>
+struct FixedSize { static constexpr size_t value = 0; };
+template <typename T> requires std::is_integral_v<T>
+struct FixedSize<T> { static constexpr size_t value = sizeof(T); };
+template <size_t N>
+struct FixedSize<std::array<uint8_t, N>> { static constexpr size_t value = N; };
+template <typename T>
+inline constexpr size_t FIXED_SIZE = FixedSize<T>::value;
+
+//////////////////////////////// DECLARATIONS ////////////////////////////////
+
+// All declared up front so they can find each other whatever the nesting.
+
+template <OutStream S> void     WriteCompactSize(S& s, uint64_t size);
+template <InStream S>  uint64_t ReadCompactSize(S& s);
+
+template <OutStream S, typename T> requires std::is_integral_v<T>
+void Serialize(S& s, T value);
+template <InStream S, typename T> requires std::is_integral_v<T>
+void Unserialize(S& s, T& value);
+
+template <OutStream S, size_t N> void Serialize(S& s, const std::array<uint8_t, N>& bytes);
+template <InStream S, size_t N>  void Unserialize(S& s, std::array<uint8_t, N>& bytes);
+
+template <OutStream S, typename T, typename A> void Serialize(S& s, const std::vector<T, A>& items);
+template <InStream S, typename T, typename A>  void Unserialize(S& s, std::vector<T, A>& items);
+
+template <OutStream S, typename T> requires requires(const T& t, S& s) { t.Serialize(s); }
+void Serialize(S& s, const T& object);
+template <InStream S, typename T> requires requires(T& t, S& s) { t.Unserialize(s); }
+void Unserialize(S& s, T& object);
+
+///////////////////////////////// COMPACTSIZE ////////////////////////////////
+
+// Through the span codec in CompactSize.hpp, so streams get the same
+// canonical-encoding checks.
+template <OutStream S>
+void WriteCompactSize(S& s, uint64_t size) {
+    uint8_t bytes[9];
+    s.WriteBytes(std::span<const uint8_t>(bytes, EncodeCompactSize(size, bytes)));
+}
+
+template <InStream S>
+uint64_t ReadCompactSize(S& s) {
+    uint8_t prefix;
+    ::Unserialize(s, prefix);
+    size_t length = GetCompactSizeSizeFromPrefix(prefix);
+    if (length == 1)
+        return prefix;
+    uint8_t bytes[9] = {prefix};
+    std::span<const uint8_t> rest = s.ReadBytes(length - 1);
+    std::copy(rest.begin(), rest.end(), bytes + 1);
+    uint64_t size;
+    DecodeCompactSize(std::span<const uint8_t>(bytes, length), size);
+    return size;
+}
+
+////////////////////////////////// INTEGERS //////////////////////////////////
+
+template <OutStream S, typename T> requires std::is_integral_v<T>
+inline void Serialize(S& s, T value) {
+    uint8_t bytes[sizeof(T)];
+    WriteLE(bytes, value);
+    s.WriteBytes(bytes);
+}
+
+template <InStream S, typename T> requires std::is_integral_v<T>
+inline void Unserialize(S& s, T& value) {
+    value = ReadLE<T>(s.ReadBytes(sizeof(T)).data());
+}
+
+//////////////////////////////// BYTE ARRAYS /////////////////////////////////
+
+template <OutStream S, size_t N>
+void Serialize(S& s, const std::array<uint8_t, N>& bytes) {
+    s.WriteBytes(bytes);
+}
+
+template <InStream S, size_t N>
+void Unserialize(S& s, std::array<uint8_t, N>& bytes) {
+    std::span<const uint8_t> read = s.ReadBytes(N);
+    std::copy(read.begin(), read.end(), bytes.begin());
+}
+
+////////////////////////////////// VECTORS ///////////////////////////////////
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/serialize.h#L29
+static const size_t MAX_VECTOR_ALLOCATE = 5000000;
+
+template <OutStream S, typename T, typename A>
+void Serialize(S& s, const std::vector<T, A>& items) {
+    WriteCompactSize(s, items.size());
+    if constexpr (std::is_same_v<T, uint8_t>)
+        s.WriteBytes(items);
+    else
+        for (auto& item: items)
+            ::Serialize(s, item);
+}
+
+template <InStream S, typename T, typename A>
+void Unserialize(S& s, std::vector<T, A>& items) {
+    uint64_t size = ReadCompactSize(s);
+    items.clear();
+    if constexpr (std::is_same_v<T, uint8_t>) {
+        std::span<const uint8_t> bytes = s.ReadBytes(size);
+        items.assign(bytes.begin(), bytes.end());
+    } else {
+        // `size` is untrusted: reserve no more elements than the rest of the
+        // stream could hold (a byte each at least, more for fixed-size
+        // types), nor more than MAX_VECTOR_ALLOCATE bytes of them, past
+        // which emplace_back grows the vector as elements actually parse.
+        if constexpr (requires { s.Remaining(); })
+            items.reserve(std::min<uint64_t>({size, s.Remaining() / std::max<size_t>(FIXED_SIZE<T>, 1),
+                                              MAX_VECTOR_ALLOCATE / sizeof(T)}));
+        for (uint64_t i = 0; i < size; i++) {
+            if constexpr (std::is_same_v<A, std::pmr::polymorphic_allocator<T>> &&
+                          std::is_constructible_v<T, S&, std::pmr::memory_resource*>)
+                items.emplace_back(s, items.get_allocator().resource());
+            else if constexpr (std::is_constructible_v<T, S&>)
+                items.emplace_back(s);
+            else
+                ::Unserialize(s, items.emplace_back());
+        }
+    }
+}
+
+////////////////////////////////// OBJECTS ///////////////////////////////////
+
+template <OutStream S, typename T> requires requires(const T& t, S& s) { t.Serialize(s); }
+void Serialize(S& s, const T& object) {
+    object.Serialize(s);
+}
+
+template <InStream S, typename T> requires requires(T& t, S& s) { t.Unserialize(s); }
+void Unserialize(S& s, T& object) {
+    object.Unserialize(s);
+}
+
+template <OutStream S, typename... Ts>
+void SerializeMany(S& s, const Ts&... fields) {
+    (::Serialize(s, fields), ...);
+}
+
+template <InStream S, typename... Ts>
+void UnserializeMany(S& s, Ts&... fields) {
+    (::Unserialize(s, fields), ...);
+}
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,370 @@
+#include "sha256.hpp"
+#include "endian.hpp"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SHA256_X86 1
+#endif
+
+// FIPS 180-4, section 4.2.2.
+static constexpr uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+namespace Sha256 {
+
+////////////////////////////////// SCALAR ////////////////////////////////////
+
+static inline uint32_t Rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+static void TransformScalar(std::array<uint32_t, 8>& state, const uint8_t* block) {
+    uint32_t w[16];
+    for (int i = 0; i < 16; i++)
+        w[i] = ReadBE32(block + 4*i);
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+#pragma GCC unroll 64
+    for (int t = 0; t < 64; t++) {
+        if (t >= 16) {
+            uint32_t w15 = w[(t - 15) & 15], w2 = w[(t - 2) & 15];
+            w[t & 15] += (Rotr(w15, 7) ^ Rotr(w15, 18) ^ (w15 >> 3)) + w[(t - 7) & 15] +
+                         (Rotr(w2, 17) ^ Rotr(w2, 19) ^ (w2 >> 10));
+        }
+        uint32_t t1 = h + (Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[t] + w[t & 15];
+        uint32_t t2 = (Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+// Padding of the second block of a header (its last 16 bytes, 640 bits in
+// all) and of a 32-byte digest (256 bits).
+static void PadHeaderTail(const uint8_t* header, uint8_t block[64]) {
+    std::fill(block, block + 64, 0);
+    std::copy(header + 64, header + 80, block);
+    block[16] = 0x80;
+    WriteBE32(block + 60, 640);
+}
+
+static void PadDigest(const std::array<uint32_t, 8>& digest, uint8_t block[64]) {
+    std::fill(block, block + 64, 0);
+    for (int i = 0; i < 8; i++)
+        WriteBE32(block + 4*i, digest[i]);
+    block[32] = 0x80;
+    WriteBE32(block + 60, 256);
+}
+
+// Top 32 bits of a hash as a number, its last 4 bytes read little-endian.
+static inline uint32_t TopWord(const std::array<uint32_t, 8>& digest) {
+    return __builtin_bswap32(digest[7]);
+}
+
+static void Hash80One(const uint8_t* header, Hash256& out, Isa isa) {
+    uint8_t block[64];
+    auto state = INIT;
+    Transform(state, header, 1, isa);
+    PadHeaderTail(header, block);
+    Transform(state, block, 1, isa);
+    PadDigest(state, block);
+    state = INIT;
+    Transform(state, block, 1, isa);
+    for (int i = 0; i < 8; i++)
+        WriteBE32(out.data() + 4*i, state[i]);
+}
+
+#ifdef SHA256_X86
+
+/////////////////////////////////// SHA-NI ///////////////////////////////////
+
+// sha256rnds2 keeps the state as ABEF / CDGH rather than ABCD / EFGH. `N`
+// independent messages are interleaved, sha256rnds2 issuing faster than its
+// latency: 2 make up for the lanes of AVX2 when mining.
+template <int N>
+__attribute__((target("sha,sse4.1")))
+static inline void TransformSHANI(std::array<uint32_t, 8>* states, const uint8_t* const* blocks) {
+    const __m128i bswap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    __m128i abef[N], cdgh[N], abef_start[N], cdgh_start[N], m[N][4];
+    for (int k = 0; k < N; k++) {
+        __m128i abcd = _mm_loadu_si128((const __m128i*)&states[k][0]);
+        __m128i efgh = _mm_loadu_si128((const __m128i*)&states[k][4]);
+        __m128i badc = _mm_shuffle_epi32(abcd, 0xb1);
+        __m128i hgfe = _mm_shuffle_epi32(efgh, 0x1b);
+        abef[k] = abef_start[k] = _mm_alignr_epi8(badc, hgfe, 8);
+        cdgh[k] = cdgh_start[k] = _mm_blend_epi16(hgfe, badc, 0xf0);
+        for (int i = 0; i < 4; i++)
+            m[k][i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks[k] + 16*i)), bswap);
+    }
+#pragma GCC unroll 16
+    for (int i = 0; i < 16; i++) {
+        __m128i k4 = _mm_loadu_si128((const __m128i*)&K[4*i]);
+        for (int k = 0; k < N; k++) {
+            // W[4i..4i+3] from the previous four groups.
+            if (i >= 4) {
+                __m128i next = _mm_sha256msg1_epu32(m[k][i & 3], m[k][(i + 1) & 3]);
+                next         = _mm_add_epi32(next, _mm_alignr_epi8(m[k][(i + 3) & 3], m[k][(i + 2) & 3], 4));
+                m[k][i & 3]  = _mm_sha256msg2_epu32(next, m[k][(i + 3) & 3]);
+            }
+            __m128i wk = _mm_add_epi32(m[k][i & 3], k4);
+            cdgh[k] = _mm_sha256rnds2_epu32(cdgh[k], abef[k], wk);
+            abef[k] = _mm_sha256rnds2_epu32(abef[k], cdgh[k], _mm_shuffle_epi32(wk, 0x0e));
+        }
+    }
+    for (int k = 0; k < N; k++) {
+        __m128i feba = _mm_shuffle_epi32(_mm_add_epi32(abef[k], abef_start[k]), 0x1b);
+        __m128i dchg = _mm_shuffle_epi32(_mm_add_epi32(cdgh[k], cdgh_start[k]), 0xb1);
+        _mm_storeu_si128((__m128i*)&states[k][0], _mm_blend_epi16(feba, dchg, 0xf0));
+        _mm_storeu_si128((__m128i*)&states[k][4], _mm_alignr_epi8(dchg, feba, 8));
+    }
+}
+
+__attribute__((target("sha,sse4.1")))
+static std::optional<uint32_t> ScanNoncesSHANI(const std::array<uint32_t, 8>& midstate, const uint8_t* tail,
+                                               uint32_t first, uint64_t count, uint32_t max_top) {
+    uint8_t header[80] = {}, block[2][64], digest[2][64];
+    std::copy(tail, tail + 12, header + 64);
+    PadHeaderTail(header, block[0]);
+    PadHeaderTail(header, block[1]);
+    const uint8_t* blocks[2]  = {block[0], block[1]};
+    const uint8_t* digests[2] = {digest[0], digest[1]};
+
+    for (uint64_t i = 0; i < count; i += 2) {
+        std::array<uint32_t, 8> states[2] = {midstate, midstate};
+        WriteLE32(block[0] + 12, first + (uint32_t)i);
+        WriteLE32(block[1] + 12, first + (uint32_t)i + 1);
+        TransformSHANI<2>(states, blocks);
+        for (int k = 0; k < 2; k++) {
+            PadDigest(states[k], digest[k]);
+            states[k] = INIT;
+        }
+        TransformSHANI<2>(states, digests);
+        for (uint64_t k = 0; k < 2 && i + k < count; k++)
+            if (TopWord(states[k]) <= max_top)
+                return first + (uint32_t)(i + k);
+    }
+    return std::nullopt;
+}
+
+//////////////////////////////////// AVX2 ////////////////////////////////////
+
+// Eight messages, one per 32-bit lane: w[i] holds word i of each.
+
+__attribute__((target("avx2")))
+static inline __m256i Rotr8(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i Add8(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+
+// The first `ROUNDS` rounds on v = a..h, w[] becoming the message schedule.
+template <int ROUNDS>
+__attribute__((target("avx2")))
+static inline void Rounds8(__m256i v[8], __m256i w[16]) {
+    __m256i a = v[0], b = v[1], c = v[2], d = v[3];
+    __m256i e = v[4], f = v[5], g = v[6], h = v[7];
+#pragma GCC unroll 64
+    for (int t = 0; t < ROUNDS; t++) {
+        if (t >= 16) {
+            __m256i w15 = w[(t - 15) & 15], w2 = w[(t - 2) & 15];
+            __m256i s0  = _mm256_xor_si256(_mm256_xor_si256(Rotr8(w15, 7), Rotr8(w15, 18)),
+                                           _mm256_srli_epi32(w15, 3));
+            __m256i s1  = _mm256_xor_si256(_mm256_xor_si256(Rotr8(w2, 17), Rotr8(w2, 19)),
+                                           _mm256_srli_epi32(w2, 10));
+            w[t & 15] = Add8(Add8(w[t & 15], s0), Add8(w[(t - 7) & 15], s1));
+        }
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(Rotr8(e, 6), Rotr8(e, 11)), Rotr8(e, 25));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = Add8(Add8(Add8(h, s1), Add8(ch, _mm256_set1_epi32(K[t]))), w[t & 15]);
+        __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(Rotr8(a, 2), Rotr8(a, 13)), Rotr8(a, 22));
+        __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        __m256i t2 = Add8(s0, maj);
+        h = g; g = f; f = e; e = Add8(d, t1);
+        d = c; c = b; b = a; a = Add8(t1, t2);
+    }
+    v[0] = a; v[1] = b; v[2] = c; v[3] = d;
+    v[4] = e; v[5] = f; v[6] = g; v[7] = h;
+}
+
+__attribute__((target("avx2")))
+static void Transform8(__m256i state[8], __m256i w[16]) {
+    __m256i v[8];
+    std::copy(state, state + 8, v);
+    Rounds8<64>(v, w);
+    for (int i = 0; i < 8; i++)
+        state[i] = Add8(state[i], v[i]);
+}
+
+// Word `i` (big-endian) of 8 messages `stride` bytes apart.
+__attribute__((target("avx2")))
+static inline __m256i Gather8(const uint8_t* in, size_t stride, int i) {
+    return _mm256_setr_epi32(ReadBE32(in + 4*i),              ReadBE32(in + stride + 4*i),
+                             ReadBE32(in + 2*stride + 4*i),   ReadBE32(in + 3*stride + 4*i),
+                             ReadBE32(in + 4*stride + 4*i),   ReadBE32(in + 5*stride + 4*i),
+                             ReadBE32(in + 6*stride + 4*i),   ReadBE32(in + 7*stride + 4*i));
+}
+
+__attribute__((target("avx2")))
+static void Hash80x8(const uint8_t* headers, Hash256* out) {
+    __m256i w[16], state[8], midstate[8];
+
+    for (int i = 0; i < 8; i++)
+        state[i] = _mm256_set1_epi32(INIT[i]);
+    for (int i = 0; i < 16; i++)
+        w[i] = Gather8(headers, 80, i);
+    Transform8(state, w);
+
+    for (int i = 0; i < 4; i++)
+        w[i] = Gather8(headers, 80, 16 + i);
+    w[4] = _mm256_set1_epi32(0x80000000);
+    for (int i = 5; i < 15; i++)
+        w[i] = _mm256_setzero_si256();
+    w[15] = _mm256_set1_epi32(640);
+    Transform8(state, w);
+
+    for (int i = 0; i < 8; i++) {
+        w[i]        = state[i];
+        midstate[i] = _mm256_set1_epi32(INIT[i]);
+    }
+    w[8] = _mm256_set1_epi32(0x80000000);
+    for (int i = 9; i < 15; i++)
+        w[i] = _mm256_setzero_si256();
+    w[15] = _mm256_set1_epi32(256);
+    Transform8(midstate, w);
+
+    alignas(32) uint32_t words[8][8];
+    for (int i = 0; i < 8; i++)
+        _mm256_store_si256((__m256i*)words[i], midstate[i]);
+    for (int lane = 0; lane < 8; lane++)
+        for (int i = 0; i < 8; i++)
+            WriteBE32(out[lane].data() + 4*i, words[i][lane]);
+}
+
+// Final word of the second compression only: h after the last round is e
+// after round 61, so the last 3 rounds are skipped.
+__attribute__((target("avx2")))
+static std::optional<uint32_t> ScanNoncesAVX2(const std::array<uint32_t, 8>& midstate, const uint8_t* tail,
+                                              uint32_t first, uint64_t count, uint32_t max_top) {
+    const __m256i bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                           3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i top   = _mm256_set1_epi32(max_top);
+
+    for (uint64_t i = 0; i < count; i += 8) {
+        __m256i w[16], state[8], v[8];
+        for (int j = 0; j < 8; j++)
+            state[j] = _mm256_set1_epi32(midstate[j]);
+        for (int j = 0; j < 3; j++)
+            w[j] = _mm256_set1_epi32(ReadBE32(tail + 4*j));
+        // The nonce is little-endian in the header, read big-endian here.
+        w[3] = _mm256_shuffle_epi8(Add8(_mm256_set1_epi32(first + (uint32_t)i), lanes), bswap);
+        w[4] = _mm256_set1_epi32(0x80000000);
+        for (int j = 5; j < 15; j++)
+            w[j] = _mm256_setzero_si256();
+        w[15] = _mm256_set1_epi32(640);
+        Transform8(state, w);
+
+        for (int j = 0; j < 8; j++) {
+            w[j] = state[j];
+            v[j] = _mm256_set1_epi32(INIT[j]);
+        }
+        w[8] = _mm256_set1_epi32(0x80000000);
+        for (int j = 9; j < 15; j++)
+            w[j] = _mm256_setzero_si256();
+        w[15] = _mm256_set1_epi32(256);
+        Rounds8<61>(v, w);
+
+        // Unsigned top <= max_top, as max(top, max_top) == max_top.
+        __m256i digest7 = _mm256_shuffle_epi8(Add8(v[4], _mm256_set1_epi32(INIT[7])), bswap);
+        __m256i pass    = _mm256_cmpeq_epi32(_mm256_max_epu32(digest7, top), top);
+        unsigned mask   = _mm256_movemask_ps(_mm256_castsi256_ps(pass));
+        if (count - i < 8)
+            mask &= (1u << (count - i)) - 1;
+        if (mask)
+            return first + (uint32_t)i + __builtin_ctz(mask);
+    }
+    return std::nullopt;
+}
+
+#endif // SHA256_X86
+
+//////////////////////////////////////////////////////////////////////////////
+
+Isa Detect() {
+    static const Isa best = Supported(Isa::SHANI) ? Isa::SHANI
+                          : Supported(Isa::AVX2)  ? Isa::AVX2 : Isa::Scalar;
+    return best;
+}
+
+bool Supported(Isa isa) {
+#ifdef SHA256_X86
+    switch (isa) {
+    case Isa::SHANI: return __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+    case Isa::AVX2:  return __builtin_cpu_supports("avx2");
+    default:         return true;
+    }
+#else
+    return isa == Isa::Scalar;
+#endif
+}
+
+void Transform(std::array<uint32_t, 8>& state, const uint8_t* blocks, size_t n_blocks, Isa isa) {
+    for (size_t i = 0; i < n_blocks; i++) {
+#ifdef SHA256_X86
+        if (isa == Isa::SHANI) {
+            const uint8_t* block = blocks + 64*i;
+            TransformSHANI<1>(&state, &block);
+            continue;
+        }
+#endif
+        TransformScalar(state, blocks + 64*i);
+    }
+}
+
+void Hash80(const uint8_t* headers, size_t n, Hash256* out, Isa isa) {
+    size_t i = 0;
+#ifdef SHA256_X86
+    if (isa == Isa::AVX2)
+        for (; i + 8 <= n; i += 8)
+            Hash80x8(headers + 80*i, out + i);
+#endif
+    for (; i < n; i++)
+        Hash80One(headers + 80*i, out[i], isa);
+}
+
+std::optional<uint32_t> ScanNonces(const std::array<uint32_t, 8>& midstate, const uint8_t* tail,
+                                   uint32_t first, uint64_t count, uint32_t max_top, Isa isa) {
+#ifdef SHA256_X86
+    if (isa == Isa::AVX2)
+        return ScanNoncesAVX2(midstate, tail, first, count, max_top);
+    if (isa == Isa::SHANI)
+        return ScanNoncesSHANI(midstate, tail, first, count, max_top);
+#endif
+    uint8_t header[80] = {}, block[64], digest[64];
+    std::copy(tail, tail + 12, header + 64);
+    PadHeaderTail(header, block);
+    for (uint64_t i = 0; i < count; i++) {
+        uint32_t nonce = first + (uint32_t)i;
+        WriteLE32(block + 12, nonce);
+        auto state = midstate;
+        Transform(state, block, 1, isa);
+        PadDigest(state, digest);
+        state = INIT;
+        Transform(state, digest, 1, isa);
+        if (TopWord(state) <= max_top)
+            return nonce;
+    }
+    return std::nullopt;
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "hashes.hpp"
+
+#include <span>
+#include <array>
+#include <cstdint>
+#include <optional>
+
+// SHA-256 compression for the hot paths of proof of work, where OpenSSL's
+// streaming API costs more than the hashing: a portable scalar version, an
+// x86 SHA extensions (SHA-NI) one and an AVX2 one hashing 8 independent
+// messages in the lanes of its registers, picked at runtime.
+namespace Sha256 {
+    enum class Isa { Scalar, AVX2, SHANI };
+
+    // Best implementation this CPU supports / whether it supports `isa`.
+    Isa  Detect();
+    bool Supported(Isa isa);
+
+    // Initial hash value (the state before any block).
+    inline constexpr std::array<uint32_t, 8> INIT = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    // Compress `n_blocks` consecutive 64-byte blocks into `state`. Lanes
+    // don't help a single stream, AVX2 runs the scalar version.
+    void Transform(std::array<uint32_t, 8>& state, const uint8_t* blocks, size_t n_blocks,
+                   Isa isa = Detect());
+
+    // hash256() of each of `n` consecutive 80-byte block headers, serialized
+    // order, i.e. the block hashes.
+    void Hash80(const uint8_t* headers, size_t n, Hash256* out, Isa isa = Detect());
+
+    // Mining: block hashes of a header for nonces [first, first + count)
+    // (at most 2^32 in all), its first 64 bytes compressed into `midstate`
+    // (Transform() from INIT) and `tail` its next 12 (end of the merkle root,
+    // time, bits). Returns the first nonce whose hash has its top 32 bits,
+    // as a number, at most `max_top`, a cheap first check that the caller
+    // confirms on the whole hash (CheckProofOfWork). AVX2 scans 8 nonces at
+    // once and skips the rounds that don't contribute to that word.
+    std::optional<uint32_t> ScanNonces(const std::array<uint32_t, 8>& midstate, const uint8_t* tail,
+                                       uint32_t first, uint64_t count, uint32_t max_top,
+                                       Isa isa = Detect());
+}
@@ -0,0 +1,348 @@
+#include "txformat.hpp"
+#include "Script.hpp"
+#include "utils.hpp"
+
+#include <charconv>
+#include <algorithm>
+
+// Output cursor over a caller buffer, counts what doesn't fit.
+class Out {
+public:
+    explicit Out(std::span<char> buffer): pos(buffer.data()), end(buffer.data() + buffer.size()) {}
+
+    size_t Size() const { return size; }
+
+    void Put(char c) {
+        if (pos < end) *pos++ = c;
+        size++;
+    }
+
+    void Put(std::string_view str) {
+        size_t n = std::min<size_t>(str.size(), end - pos);
+        std::copy_n(str.data(), n, pos);
+        pos  += n;
+        size += str.size();
+    }
+
+    void Int(int64_t value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        Put(std::string_view(digits, result.ptr - digits));
+    }
+
+    void Hex(std::span<const uint8_t> bytes) {
+        if ((size_t)(end - pos) >= bytes.size() * 2)
+            pos = toHex(bytes, pos);
+        else {
+            char pair[2];
+            for (auto b: bytes) {
+                toHex({&b, 1}, pair);
+                Put(std::string_view(pair, 2));
+            }
+            return;
+        }
+        size += bytes.size() * 2;
+    }
+
+    // Hashes are displayed byte-reversed.
+    void HexReversed(std::span<const uint8_t> bytes) {
+        for (size_t i = bytes.size(); i > 0; i--)
+            Hex(bytes.subspan(i - 1, 1));
+    }
+
+    // Satoshis as BTC with 8 decimals (Core's ValueFromAmount).
+    void Amount(int64_t satoshis) {
+        uint64_t abs = satoshis < 0 ? -(uint64_t)satoshis : satoshis;
+        if (satoshis < 0)
+            Put('-');
+        Int(abs / 100000000);
+        Put('.');
+        char decimals[8];
+        uint64_t remainder = abs % 100000000;
+        for (int i = 7; i >= 0; i--, remainder /= 10)
+            decimals[i] = '0' + remainder % 10;
+        Put(std::string_view(decimals, 8));
+    }
+
+private:
+    char*  pos;
+    char*  end;
+    size_t size = 0;
+};
+
+//////////////////////////////// SCRIPT ASM //////////////////////////////////
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/script/interpreter.cpp#L97
+static bool IsValidSignatureEncoding(std::span<const uint8_t> sig) {
+    // Format: 0x30 [total-length] 0x02 [R-length] [R] 0x02 [S-length] [S] [sighash]
+    if (sig.size() < 9 || sig.size() > 73) return false;
+    if (sig[0] != 0x30)                    return false;
+    if (sig[1] != sig.size() - 3)          return false;
+    size_t len_r = sig[3];
+    if (5 + len_r >= sig.size())           return false;
+    size_t len_s = sig[5 + len_r];
+    if (len_r + len_s + 7 != sig.size())   return false;
+
+    if (sig[2] != 0x02)                                   return false;
+    if (len_r == 0)                                       return false;
+    if (sig[4] & 0x80)                                    return false;
+    if (len_r > 1 && sig[4] == 0x00 && !(sig[5] & 0x80))  return false;
+
+    if (sig[len_r + 4] != 0x02)                                             return false;
+    if (len_s == 0)                                                         return false;
+    if (sig[len_r + 6] & 0x80)                                              return false;
+    if (len_s > 1 && sig[len_r + 6] == 0x00 && !(sig[len_r + 7] & 0x80))   return false;
+    return true;
+}
+
+static const char* SigHashName(uint8_t hash_type) {
+    switch (hash_type) {
+        case 0x01: return "ALL";
+        case 0x02: return "NONE";
+        case 0x03: return "SINGLE";
+        case 0x81: return "ALL|ANYONECANPAY";
+        case 0x82: return "NONE|ANYONECANPAY";
+        case 0x83: return "SINGLE|ANYONECANPAY";
+        default:   return nullptr;
+    }
+}
+
+// Little-endian sign-magnitude, no minimal encoding check (at most 4 bytes).
+static int64_t DecodeSmallNum(std::span<const uint8_t> bytes) {
+    if (bytes.empty())
+        return 0;
+    int64_t value = 0;
+    for (size_t i = 0; i < bytes.size(); i++)
+        value |= (int64_t)bytes[i] << (8*i);
+    if (bytes.back() & 0x80)
+        return -(value & ~((int64_t)0x80 << (8*(bytes.size()-1))));
+    return value;
+}
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/core_write.cpp#L86
+static void WriteAsm(Out& out, std::span<const uint8_t> script, bool decode_sighash) {
+    const uint8_t* pc  = script.data();
+    const uint8_t* end = script.data() + script.size();
+    const uint8_t* data;
+    uint32_t       data_size;
+    uint8_t        opcode;
+    bool           unspendable = !script.empty() && script[0] == OP_RETURN;
+
+    while (pc < end) {
+        if (pc != script.data())
+            out.Put(' ');
+        if (!Script::GetOp(pc, end, opcode, data, data_size)) {
+            out.Put("[error]");
+            return;
+        }
+        if (opcode > OP_PUSHDATA4) {
+            out.Put(Script::GetOpName(opcode));
+            continue;
+        }
+        std::span<const uint8_t> push(data, data_size);
+        if (push.size() <= 4) {
+            out.Int(DecodeSmallNum(push));
+            continue;
+        }
+        const char* hash_type = nullptr;
+        if (decode_sighash && !unspendable && IsValidSignatureEncoding(push))
+            hash_type = SigHashName(push.back());
+        if (hash_type) {
+            out.Hex(push.first(push.size() - 1));
+            out.Put('[');
+            out.Put(hash_type);
+            out.Put(']');
+        } else out.Hex(push);
+    }
+}
+
+std::string ScriptToAsm(std::span<const uint8_t> script, bool decode_sighash) {
+    std::string asm_script(script.size() * 3, '\0');
+    Out out(asm_script);
+    WriteAsm(out, script, decode_sighash);
+    if (out.Size() > asm_script.size()) {
+        asm_script.assign(out.Size(), '\0');
+        Out retry(asm_script);
+        WriteAsm(retry, script, decode_sighash);
+    }
+    asm_script.resize(out.Size());
+    return asm_script;
+}
+
+// Length a public key with this header byte must have, 0 if none is valid.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/pubkey.h#L60
+static size_t PubKeySize(uint8_t header) {
+    if (header == 2 || header == 3)
+        return 33;
+    if (header == 4 || header == 6 || header == 7)
+        return 65;
+    return 0;
+}
+
+static bool IsPubKey(const uint8_t* data, size_t size) {
+    return size > 0 && PubKeySize(data[0]) == size;
+}
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/script/standard.cpp#L43
+static const char* ScriptType(std::span<const uint8_t> script) {
+    size_t size = script.size();
+
+    // OP_n <2..40 bytes>
+    if (size >= 4 && size <= 42 && (script[0] == OP_0 || (script[0] >= OP_1 && script[0] <= OP_16))
+                  && script[1] + 2u == size) {
+        if (script[0] == OP_0 && size == 22) return "witness_v0_keyhash";
+        if (script[0] == OP_0 && size == 34) return "witness_v0_scripthash";
+        if (script[0] == OP_1 && size == 34) return "witness_v1_taproot";
+        if (script[0] != OP_0)               return "witness_unknown";
+        return "nonstandard";
+    }
+    if (size == 23 && script[0] == OP_HASH160 && script[1] == 20 && script[22] == OP_EQUAL)
+        return "scripthash";
+    if (size == 25 && script[0] == OP_DUP && script[1] == OP_HASH160 && script[2] == 20
+                   && script[23] == OP_EQUALVERIFY && script[24] == OP_CHECKSIG)
+        return "pubkeyhash";
+    if ((size == 35 && script[0] == 33) || (size == 67 && script[0] == 65))
+        if (script[size-1] == OP_CHECKSIG && IsPubKey(&script[1], script[0]))
+            return "pubkey";
+
+    const uint8_t* pc  = script.data();
+    const uint8_t* end = script.data() + size;
+    const uint8_t* data;
+    uint32_t       data_size;
+    uint8_t        opcode;
+
+    // OP_RETURN <pushes>
+    if (size >= 1 && script[0] == OP_RETURN) {
+        pc++;
+        while (pc < end)
+            if (!Script::GetOp(pc, end, opcode, data, data_size) || opcode > OP_16)
+                return "nonstandard";
+        return "nulldata";
+    }
+
+    // OP_m <pubkeys> OP_n OP_CHECKMULTISIG
+    if (size >= 3 && script[0] >= OP_1 && script[0] <= OP_16 && script[size-1] == OP_CHECKMULTISIG) {
+        size_t required = script[0] - (OP_1 - 1);
+        size_t keys     = 0;
+        pc++;
+        while (pc < end - 2) {
+            if (!Script::GetOp(pc, end, opcode, data, data_size) || !IsPubKey(data, data_size))
+                return "nonstandard";
+            keys++;
+        }
+        // OP_n, n being the number of keys, at least m.
+        uint8_t op_n = script[size-2];
+        if (pc == end - 2 && op_n >= OP_1 && op_n <= OP_16 && size_t(op_n - (OP_1 - 1)) == keys
+                          && required <= keys)
+            return "multisig";
+    }
+    return "nonstandard";
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static bool IsCoinbase(const TxView& tx) {
+    if (tx.InputCount() != 1 || tx.PrevIndex(0) != 0xffffffff)
+        return false;
+    auto txid = tx.PrevTxId(0);
+    return std::all_of(txid.begin(), txid.end(), [](uint8_t b) { return b == 0; });
+}
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/core_write.cpp#L176
+static void WriteJson(Out& out, const TxView& tx) {
+    out.Put("{\"txid\":\"");       out.HexReversed(tx.TxId());
+    out.Put("\",\"hash\":\"");     out.HexReversed(tx.WTxId());
+    out.Put("\",\"version\":");    out.Int(tx.Version());
+    out.Put(",\"size\":");         out.Int(tx.Bytes().size());
+    out.Put(",\"vsize\":");        out.Int((tx.Weight() + 3) / 4);
+    out.Put(",\"weight\":");       out.Int(tx.Weight());
+    out.Put(",\"locktime\":");     out.Int(tx.LockTime());
+
+    out.Put(",\"vin\":[");
+    bool coinbase = IsCoinbase(tx);
+    for (size_t i = 0; i < tx.InputCount(); i++) {
+        if (i) out.Put(',');
+        if (coinbase) {
+            out.Put("{\"coinbase\":\"");       out.Hex(tx.ScriptSig(i));
+            out.Put('"');
+        } else {
+            out.Put("{\"txid\":\"");           out.HexReversed(tx.PrevTxId(i));
+            out.Put("\",\"vout\":");           out.Int(tx.PrevIndex(i));
+            out.Put(",\"scriptSig\":{\"asm\":\""); WriteAsm(out, tx.ScriptSig(i), true);
+            out.Put("\",\"hex\":\"");          out.Hex(tx.ScriptSig(i));
+            out.Put("\"}");
+        }
+        if (tx.WitnessSize(i)) {
+            out.Put(",\"txinwitness\":[");
+            for (size_t item = 0; item < tx.WitnessSize(i); item++) {
+                out.Put(item ? ",\"" : "\"");
+                out.Hex(tx.WitnessItem(i, item));
+                out.Put('"');
+            }
+            out.Put(']');
+        }
+        out.Put(",\"sequence\":");             out.Int(tx.Sequence(i));
+        out.Put('}');
+    }
+
+    out.Put("],\"vout\":[");
+    for (size_t i = 0; i < tx.OutputCount(); i++) {
+        if (i) out.Put(',');
+        out.Put("{\"value\":");                out.Amount(tx.Amount(i));
+        out.Put(",\"n\":");                    out.Int(i);
+        out.Put(",\"scriptPubKey\":{\"asm\":\""); WriteAsm(out, tx.ScriptPubKey(i), false);
+        out.Put("\",\"hex\":\"");              out.Hex(tx.ScriptPubKey(i));
+        out.Put("\",\"type\":\"");             out.Put(ScriptType(tx.ScriptPubKey(i)));
+        out.Put("\"}}");
+    }
+    out.Put("]}");
+}
+
+static void WriteText(Out& out, const TxView& tx) {
+    out.Put("Transaction: ");          out.HexReversed(tx.TxId());
+    out.Put("\n\nVersion: ");          out.Int(tx.Version());
+    out.Put("\n\nInputs: ");           out.Int(tx.InputCount());
+    out.Put('\n');
+    for (size_t i = 0; i < tx.InputCount(); i++) {
+        out.Put("    txid          : "); out.HexReversed(tx.PrevTxId(i));
+        out.Put("\n    txid_idx      : "); out.Int(tx.PrevIndex(i));
+        out.Put("\n    script_length : "); out.Int(tx.ScriptSig(i).size());
+        out.Put("\n    script bytes  : "); out.Hex(tx.ScriptSig(i));
+        for (size_t item = 0; item < tx.WitnessSize(i); item++) {
+            out.Put("\n    witness       : "); out.Hex(tx.WitnessItem(i, item));
+        }
+        out.Put("\n    sequence      : "); out.Int(tx.Sequence(i));
+        out.Put("\n\n");
+    }
+    out.Put("\nOutputs: ");            out.Int(tx.OutputCount());
+    out.Put('\n');
+    for (size_t i = 0; i < tx.OutputCount(); i++) {
+        out.Put("    satoshis   : ");    out.Int(tx.Amount(i));
+        out.Put("\n    script_len : ");  out.Int(tx.ScriptPubKey(i).size());
+        out.Put("\n    script     : ");  out.Hex(tx.ScriptPubKey(i));
+        out.Put("\n\n");
+    }
+    out.Put("Locktime: ");             out.Int(tx.LockTime());
+    out.Put('\n');
+}
+
+size_t FormatTx(const TxView& tx, TxFormat format, std::span<char> buffer) {
+    Out out(buffer);
+    if (format == TxFormat::Json)
+        WriteJson(out, tx);
+    else
+        WriteText(out, tx);
+    return out.Size();
+}
+
+std::string FormatTx(const TxView& tx, TxFormat format) {
+    // Hex doubles everything, asm and field names add a bit more.
+    std::string formatted(tx.Bytes().size() * 5 + 512, '\0');
+    size_t size = FormatTx(tx, format, formatted);
+    if (size > formatted.size()) {
+        formatted.assign(size, '\0');
+        FormatTx(tx, format, formatted);
+    }
+    formatted.resize(size);
+    return formatted;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "TxView.hpp"
+
+#include <span>
+#include <string>
+
+enum class TxFormat {
+    Json, // same fields as Bitcoin Core's decoderawtransaction (compact, no addresses)
+    Text  // human readable, one field per line
+};
+
+// Write `tx` straight into `out`, no intermediate strings. Like snprintf it
+// returns the full output length, writing only what fits (no terminating
+// NUL), so a caller can retry with a larger buffer if it exceeds out.size().
+size_t FormatTx(const TxView& tx, TxFormat format, std::span<char> out);
+
+// Same, into a new string.
+std::string FormatTx(const TxView& tx, TxFormat format);
+
+// Bitcoin Core's script asm ("OP_DUP OP_HASH160 <hex> ..."). With
+// `decode_sighash`, DER signatures get their hash type as a suffix
+// ("<hex>[ALL]"), as for a scriptSig in decoderawtransaction.
+std::string ScriptToAsm(std::span<const uint8_t> script, bool decode_sighash = false);
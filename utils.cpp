@@ -1,18 +1,26 @@
 #include "utils.hpp"
+#include "hex.hpp"
+
+#include <stdexcept>
 
 std::string toHex(const std::vector<uint8_t>& input) {
-    std::stringstream bytes;
-    for (auto& b: input)
-        bytes << std::hex << std::setfill('0') << std::setw(2) << +b;
-    return std::string(bytes.str());
+    std::string hex(input.size() * 2, '\0');
+    toHex(input, hex.data());
+    return hex;
+}
+
+char* toHex(std::span<const uint8_t> input, char* out) {
+    return Hex::Encode(input, out);
+}
+
+std::string toDisplayHex(std::span<const uint8_t> hash) {
+    std::vector<uint8_t> reversed(hash.rbegin(), hash.rend());
+    return toHex(reversed);
 }
 
 std::vector<uint8_t> hex2bytes(const std::string& hex) {
-    std::vector<uint8_t> bytes;
-    for (unsigned int i = 0; i < hex.length(); i += 2) {
-        std::string byte_string = hex.substr(i, 2);
-        uint8_t byte = (uint8_t)strtol(byte_string.c_str(), NULL, 16);
-        bytes.push_back(byte);
-    }
+    std::vector<uint8_t> bytes(hex.size() / 2);
+    if (!Hex::Decode(hex, bytes.data()))
+        throw std::runtime_error("hex2bytes: invalid hex string");
     return bytes;
 }
@@ -4,14 +4,12 @@
 #include <iomanip>
 #include <vector>
 #include <stack>
+#include <span>
 
 std::string toHex(const std::vector<uint8_t>& input);
+// Lowercase hex of `input` written to `out` (2 chars per byte), returns the end.
+char* toHex(std::span<const uint8_t> input, char* out);
+// Byte-reversed hex, the display order of txids and block hashes.
+std::string toDisplayHex(std::span<const uint8_t> hash);
+// Throws std::runtime_error unless `hex` is an even number of hex digits.
 std::vector<uint8_t> hex2bytes(const std::string& hex);
-
-template <typename T>
-std::vector<uint8_t> int2bytes_LE(const T& input, size_t input_bytes_size) {
-    std::vector<uint8_t> bytes(input_bytes_size);
-    for (size_t i = 0; i < input_bytes_size; i++)
-        bytes[i] = input >> (i * 8);
-    return bytes;
-}
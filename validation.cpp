@@ -0,0 +1,88 @@
+#include "validation.hpp"
+#include "merkle.hpp"
+#include "pow.hpp"
+
+#include <set>
+#include <string>
+#include <stdexcept>
+
+static void Reject(const std::string& reason) {
+    throw std::runtime_error(reason);
+}
+
+static bool MoneyRange(int64_t amount) {
+    return amount >= 0 && amount <= MAX_MONEY;
+}
+
+void CheckTransaction(const Tx& tx) {
+    if (tx.GetInputs().empty())
+        Reject("bad-txns-vin-empty");
+    if (tx.GetOutputs().empty())
+        Reject("bad-txns-vout-empty");
+    if (tx.GetStrippedSize() * WITNESS_SCALE_FACTOR > MAX_BLOCK_WEIGHT)
+        Reject("bad-txns-oversize");
+
+    int64_t total = 0;
+    for (auto& out: tx.GetOutputs()) {
+        if (out.GetSatoshis() < 0)
+            Reject("bad-txns-vout-negative");
+        if (out.GetSatoshis() > MAX_MONEY)
+            Reject("bad-txns-vout-toolarge");
+        total += out.GetSatoshis();
+        if (!MoneyRange(total))
+            Reject("bad-txns-txouttotal-toolarge");
+    }
+
+    std::set<OutPoint> prevouts;
+    for (auto& in: tx.GetInputs())
+        if (!prevouts.insert(in.GetPrevOut()).second)
+            Reject("bad-txns-inputs-duplicate");
+
+    if (tx.IsCoinBase()) {
+        size_t size = tx.GetInputs()[0].GetScript().GetSize();
+        if (size < 2 || size > 100)
+            Reject("bad-cb-length");
+    } else
+        for (auto& in: tx.GetInputs())
+            if (in.GetPrevOut().IsNull())
+                Reject("bad-txns-prevout-null");
+}
+
+void CheckBlock(const Block& block, bool check_pow, bool check_merkle_root, const ChainParams& params) {
+    auto& header = block.GetHeader();
+    auto& txs    = block.GetTxs();
+
+    if (check_pow && !CheckProofOfWork(header.GetHash(), header.GetBits(), params))
+        Reject("high-hash");
+
+    if (check_merkle_root) {
+        bool mutated;
+        if (BlockMerkleRoot(block, &mutated) != header.GetMerkleRoot())
+            Reject("bad-txnmrklroot");
+        // Same root as a valid block, but duplicate transactions.
+        if (mutated)
+            Reject("bad-txns-duplicate");
+    }
+
+    // Witnesses aren't covered by the root, so sizes are checked without.
+    if (txs.empty() || txs.size() * WITNESS_SCALE_FACTOR > MAX_BLOCK_WEIGHT ||
+        block.GetStrippedSize() * WITNESS_SCALE_FACTOR > MAX_BLOCK_WEIGHT)
+        Reject("bad-blk-length");
+
+    if (!txs[0].IsCoinBase())
+        Reject("bad-cb-missing");
+    for (size_t i = 1; i < txs.size(); i++)
+        if (txs[i].IsCoinBase())
+            Reject("bad-cb-multiple");
+
+    uint32_t sigops = 0;
+    for (auto& tx: txs) {
+        CheckTransaction(tx);
+        for (auto& in: tx.GetInputs())
+            sigops += in.GetScript().Analyze().sigops_legacy;
+        for (auto& out: tx.GetOutputs())
+            sigops += out.GetScript().Analyze().sigops_legacy;
+    }
+    if (sigops * WITNESS_SCALE_FACTOR > MAX_BLOCK_SIGOPS_COST)
+        Reject("bad-blk-sigops");
+}
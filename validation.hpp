@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Tx.hpp"
+#include "Block.hpp"
+#include "ChainParams.hpp"
+
+#include <cstdint>
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/consensus/consensus.h
+static const size_t   MAX_BLOCK_WEIGHT      = 4000000;
+static const size_t   WITNESS_SCALE_FACTOR  = 4;
+static const uint32_t MAX_BLOCK_SIGOPS_COST = 80000;
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/amount.h
+static const int64_t  COIN                  = 100000000;
+static const int64_t  MAX_MONEY             = 21000000 * COIN;
+
+/* Context-free checks, i.e. without the UTXO set or the chain: the
+   transaction / block alone must be well formed. Both throw
+   std::runtime_error with Bitcoin Core's reject reason ("bad-txns-vin-empty",
+   "bad-txnmrklroot"...) on the first failure. */
+
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/consensus/tx_check.cpp
+void CheckTransaction(const Tx& tx);
+
+// Proof of work (against `params`' limit) and merkle root can be skipped,
+// e.g. for a block whose header was already checked, or a template being
+// assembled.
+// https://github.com/bitcoin/bitcoin/blob/v0.21.0/src/validation.cpp#L3366
+void CheckBlock(const Block& block, bool check_pow = true, bool check_merkle_root = true,
+                const ChainParams& params = ChainParams::Main());